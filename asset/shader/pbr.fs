@@ -1,41 +1,65 @@
 #version 460 core
 layout(location = 0) out vec4 FragColor;
-layout(location = 1) out int EntityID;
 
 in vec3 v_WorldPos;
 in vec3 v_Normal;
 in vec2 v_TexCoord;
+flat in int v_Skin;
+flat in float v_Emission;
+flat in int v_DrawIndex;
 
 // IBL
 layout(binding = 0) uniform sampler2D uBRDFLUT;
 layout(binding = 1) uniform samplerCube uIrradianceMap;
 layout(binding = 2) uniform samplerCube uPrefilterMap;
 
-layout(binding = 3) uniform samplerCube uShadowMap;
+// GL_COMPARE_REF_TO_TEXTURE with linear filtering, every tap is a bilinear 2x2 depth test
+layout(binding = 3) uniform samplerCubeShadow uShadowMap;
 
 layout(binding = 4) uniform sampler2D uAlbedoMap;
 layout(binding = 5) uniform sampler2D uNormalMap;
 layout(binding = 6) uniform sampler2D uRoughnessMap;
+// car skins, one layer per player
+layout(binding = 7) uniform sampler2DArray uSkinMaps;
 
 // Material
-uniform vec3 uAlbedo;
-uniform float uMetallic;
-uniform float uRoughness;
-uniform float uEmission;
-
-uniform bool uUseAlbedo;
-uniform bool uUseRoughness;
-uniform bool uUseNormal;
+// one element per indirect command, see DrawData in src/RenderQueue.h
+struct Draw
+{
+    vec3 albedo;
+    float metallic;
+    float roughness;
+    float emission;
+    vec2 uvScale;
+    int useAlbedo;
+    int useNormal;
+    int useRoughness;
+};
+
+layout(std430, binding = 1) readonly buffer DrawData
+{
+    Draw uDraws[];
+};
 // Lights
 // uniform vec3 lightPositions[4];
 // uniform vec3 lightColors[4];
 
-// Shadow
-uniform vec3 uLightPos;
-uniform float uFarPlane;
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 1) uniform ViewData
+{
+    mat4 uViewProjection;
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCamPos;
+};
+
+layout(std140, binding = 2) uniform LightData
+{
+    vec3 uLightPos;
+    float uFarPlane;
+    int uShadowTaps;
+};
 
-uniform vec3 uCamPos;
-uniform int uEntityID;
 
 const float PI = 3.14159265359;
 
@@ -107,42 +131,41 @@ vec3 FresnelSchlickRoughness(vec3 F0, float cosTheta, float roughness)
     return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(1.0 - cosTheta, 5.0);
 }
 
-vec3 sampleOffsetDirections[20] = vec3[]
+// Poisson disk, ordered so the first 4 and first 8 taps are spread over the disk as well
+const vec2 poissonDisk[16] = vec2[]
 (
-   vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1), 
-   vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
-   vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
-   vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
-   vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
+    vec2( 0.97484398,  0.75648379), vec2(-0.81544232, -0.87912464), vec2(-0.81409955,  0.91437590), vec2( 0.94558609, -0.76890725),
+    vec2( 0.14383161, -0.14100790), vec2( 0.19984126,  0.78641367), vec2(-0.09418410, -0.92938870), vec2(-0.38277543,  0.27676845),
+    vec2( 0.79197514,  0.19090188), vec2( 0.44323325, -0.97511554), vec2( 0.53742981, -0.47373420), vec2(-0.94201624, -0.39906216),
+    vec2(-0.26496911, -0.41893023), vec2(-0.24188840,  0.99706507), vec2(-0.91588581,  0.45771432), vec2( 0.34495938,  0.29387760)
 );
 
 // ----------------------------------------------------------------------------
 // Shadow Map
+// The cube stores distance to the light / uFarPlane. Returns the lit fraction, uShadowTaps (1, 4, 8
+// or 16) comparison taps are spread on a disk perpendicular to the light direction.
 float ShadowCalculation(vec3 fragPosWorldSpace)
 {
     vec3 projCoords = fragPosWorldSpace - uLightPos;
-    vec3 normal = normalize(v_Normal);
-    float bias = max(0.05 * (1.0 - dot(normal, normalize(projCoords))), 0.005);
-    const float biasModifier = 0.5f;
-    
-    bias *= 1 / (uFarPlane * biasModifier);
-    
+    const float bias = 0.15;
+    float currentDepth = (length(projCoords) - bias) / uFarPlane;
+    if (uShadowTaps <= 1)
+        return texture(uShadowMap, vec4(projCoords, currentDepth));
+
     // PCF
-    float shadow = 0.0;
     float viewDistance = length(uCamPos - fragPosWorldSpace);
-    float diskRadius =  (1.0 + (viewDistance / uFarPlane)) / 25.0;
-    float currentDepth = length(projCoords);
+    float diskRadius = (1.0 + (viewDistance / uFarPlane)) / 25.0;
+    vec3 axis = normalize(projCoords);
+    vec3 tangent = normalize(cross(axis, abs(axis.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+    vec3 bitangent = cross(axis, tangent);
 
-    bias = 0.15;
-    for (int i = 0; i < 20; ++i)
+    float lit = 0.0;
+    for (int i = 0; i < uShadowTaps; ++i)
     {
-        //  + sampleOffsetDirections[i] * diskRadius
-        float pcfDepth = texture(uShadowMap, projCoords).r * uFarPlane;
-        shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
+        vec2 offset = poissonDisk[i] * diskRadius;
+        lit += texture(uShadowMap, vec4(projCoords + tangent * offset.x + bitangent * offset.y, currentDepth));
     }
-    shadow /= 20;
-
-    return shadow;
+    return lit / float(uShadowTaps);
 }
 
 vec3 IBL(vec3 F0, vec3 Lr)
@@ -196,11 +219,15 @@ vec3 CalculateDirLights(vec3 F0)
 // ----------------------------------------------------------------------------
 void main()
 {
-    m_Params.Albedo     =  uUseAlbedo ? uAlbedo : texture(uAlbedoMap,v_TexCoord).rgb;
-    m_Params.Metalness  = uMetallic;
-    m_Params.Roughness = uUseRoughness ? uRoughness : texture(uRoughnessMap,v_TexCoord).r;
-
-    m_Params.Normal = uUseNormal ? normalize(v_Normal) : normalize(texture(uNormalMap,v_TexCoord).rgb * 2.0 - 1.0);
+    Draw draw = uDraws[v_DrawIndex];
+    if (v_Skin >= 0)
+        m_Params.Albedo = texture(uSkinMaps, vec3(v_TexCoord, v_Skin)).rgb;
+    else
+        m_Params.Albedo = draw.useAlbedo != 0 ? draw.albedo : texture(uAlbedoMap,v_TexCoord).rgb;
+    m_Params.Metalness  = draw.metallic;
+    m_Params.Roughness = draw.useRoughness != 0 ? draw.roughness : texture(uRoughnessMap,v_TexCoord).r;
+
+    m_Params.Normal = draw.useNormal != 0 ? normalize(v_Normal) : normalize(texture(uNormalMap,v_TexCoord).rgb * 2.0 - 1.0);
     m_Params.View = normalize(uCamPos - v_WorldPos);
     vec3 R = reflect(-m_Params.View, m_Params.Normal);
     m_Params.NdotV = max(dot(m_Params.Normal, m_Params.View), 0.0);
@@ -212,18 +239,13 @@ void main()
     vec3 F0 = mix(vec3(0.04), m_Params.Albedo, m_Params.Metalness);
 
     float shadowScale = ShadowCalculation(v_WorldPos);
-    shadowScale = clamp(1.0f - shadowScale, 0.0f, 1.0f);
 
     vec3 lightContribution = CalculateDirLights(F0) * shadowScale;
 
     vec3 iblContribution = IBL(F0, Lr) * 0.3f;
 
-    vec4 color = vec4(iblContribution + lightContribution + m_Params.Albedo * uEmission , 1.0);
-
-    color = color / (color + vec4(1.0));
-    color = pow(color, vec4(1.0/2.2));
+    vec4 color = vec4(iblContribution + lightContribution + m_Params.Albedo * (v_Emission >= 0.0 ? v_Emission : draw.emission) , 1.0);
 
+    // linear HDR, tonemapping and gamma are applied once per pixel in present.fs
     FragColor = vec4(color.xyz,1.0);
-
-    EntityID = uEntityID;
 }
\ No newline at end of file
@@ -6,17 +6,67 @@ layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in vec3 a_Tangent;
 layout(location = 4) in vec3 a_Binormal;
 
-uniform mat4 uViewProjection;
-uniform mat4 uModel;
-uniform vec2 UVScale;
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 1) uniform ViewData
+{
+    mat4 uViewProjection;
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCamPos;
+};
+
+// one element per drawn instance, see InstanceData in src/RenderQueue.h
+struct Instance
+{
+    mat4 model;
+    mat3 normalMatrix; // transpose(inverse(mat3(model))), computed on the CPU
+    int entityID;
+    int skin;
+    float emission;
+    int layer;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceData
+{
+    Instance uInstances[];
+};
+
+// one element per indirect command, see DrawData in src/RenderQueue.h
+struct Draw
+{
+    vec3 albedo;
+    float metallic;
+    float roughness;
+    float emission;
+    vec2 uvScale;
+    int useAlbedo;
+    int useNormal;
+    int useRoughness;
+};
+
+layout(std430, binding = 1) readonly buffer DrawData
+{
+    Draw uDraws[];
+};
+// first command of the current glMultiDrawElementsIndirect
+uniform int uDrawBase;
+
 out vec3 v_WorldPos;
 out vec3 v_Normal;
 out vec2 v_TexCoord;
+flat out int v_Skin;
+flat out float v_Emission;
+flat out int v_DrawIndex;
 
 void main()
 {
-    v_TexCoord = vec2(a_TexCoord.x * UVScale.x, (1 - a_TexCoord.y) * UVScale.y) ;
-    v_WorldPos = vec3(uModel * vec4(a_Position, 1.0));
-    v_Normal = mat3(uModel) * a_Normal;
+    Instance instance = uInstances[gl_BaseInstance + gl_InstanceID];
+    v_DrawIndex = uDrawBase + gl_DrawID;
+    vec2 uvScale = uDraws[v_DrawIndex].uvScale;
+    v_TexCoord = vec2(a_TexCoord.x * uvScale.x, (1 - a_TexCoord.y) * uvScale.y) ;
+    v_WorldPos = vec3(instance.model * vec4(a_Position, 1.0));
+    v_Normal = instance.normalMatrix * a_Normal;
+    v_Skin = instance.skin;
+    v_Emission = instance.emission;
     gl_Position = uViewProjection * vec4(v_WorldPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 460 core
+layout(location = 0) out int EntityID;
+
+flat in int v_EntityID;
+
+// only the scissor rectangle around the cursor is rasterized, see Engine::PickPass
+void main()
+{
+    EntityID = v_EntityID;
+}
\ No newline at end of file
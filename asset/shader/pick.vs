@@ -0,0 +1,36 @@
+#version 460 core
+layout(location = 0) in vec3 a_Position;
+
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 1) uniform ViewData
+{
+    mat4 uViewProjection;
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCamPos;
+};
+
+// one element per drawn instance, see InstanceData in src/RenderQueue.h
+struct Instance
+{
+    mat4 model;
+    mat3 normalMatrix; // transpose(inverse(mat3(model))), computed on the CPU
+    int entityID;
+    int skin;
+    float emission;
+    int layer;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceData
+{
+    Instance uInstances[];
+};
+
+flat out int v_EntityID;
+
+void main()
+{
+    Instance instance = uInstances[gl_BaseInstance + gl_InstanceID];
+    v_EntityID = instance.entityID;
+    gl_Position = uViewProjection * instance.model * vec4(a_Position, 1.0);
+}
\ No newline at end of file
@@ -3,9 +3,26 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
+// linear HDR scene color
 uniform sampler2D screenTexture;
+// rendered fraction of screenTexture, below 1 while dynamic resolution lowers the main pass viewport
+uniform vec2 uRenderScale;
+uniform float uExposure;
+// darkening at the corners, 0 turns the vignette off
+uniform float uVignette;
 
 void main()
 { 
-    FragColor = texture(screenTexture, TexCoords);
+    // bilinear upsampling, clamped half a texel inside the rendered region so nothing stale bleeds in
+    vec2 halfTexel = 0.5 / vec2(textureSize(screenTexture, 0));
+    vec2 uv = min(TexCoords * uRenderScale, uRenderScale - halfTexel);
+    vec3 color = texture(screenTexture, uv).rgb * uExposure;
+
+    vec2 centered = TexCoords - 0.5;
+    color *= 1.0 - uVignette * dot(centered, centered) * 2.0;
+
+    // Reinhard, then gamma
+    color = color / (color + vec3(1.0));
+    color = pow(color, vec3(1.0/2.2));
+    FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
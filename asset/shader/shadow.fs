@@ -2,8 +2,13 @@
 
 in vec4 FragPos;
 
-uniform vec3 uLightPos;
-uniform float uFarPlane;
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 2) uniform LightData
+{
+    vec3 uLightPos;
+    float uFarPlane;
+    int uShadowTaps;
+};
 
 void main()
 {
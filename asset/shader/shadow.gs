@@ -2,7 +2,11 @@
 layout (triangles) in;
 layout (triangle_strip, max_vertices=18) out;
 
-uniform mat4 shadowMatrices[6];
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 3) uniform ShadowData
+{
+    mat4 uShadowMatrices[6];
+};
 
 out vec4 FragPos; // FragPos from GS (output per emitvertex)
 
@@ -14,7 +18,7 @@ void main()
         for(int i = 0; i < 3; ++i) // for each triangle's vertices
         {
             FragPos = gl_in[i].gl_Position;
-            gl_Position = shadowMatrices[face] * FragPos;
+            gl_Position = uShadowMatrices[face] * FragPos;
             EmitVertex();
         }    
         EndPrimitive();
@@ -1,9 +1,23 @@
 #version 460 core
 layout (location = 0) in vec3 position;
 
-uniform mat4 uModel;
+// one element per drawn instance, see InstanceData in src/RenderQueue.h
+struct Instance
+{
+    mat4 model;
+    mat3 normalMatrix; // transpose(inverse(mat3(model))), computed on the CPU
+    int entityID;
+    int skin;
+    float emission;
+    int layer;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceData
+{
+    Instance uInstances[];
+};
 
 void main()
 {
-    gl_Position = uModel * vec4(position, 1.0);
+    gl_Position = uInstances[gl_BaseInstance + gl_InstanceID].model * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#version 460 core
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_layer : enable
+layout (location = 0) in vec3 position;
+
+// one element per drawn instance, see InstanceData in src/RenderQueue.h
+struct Instance
+{
+    mat4 model;
+    mat3 normalMatrix; // transpose(inverse(mat3(model))), computed on the CPU
+    int entityID;
+    int skin;
+    float emission;
+    int layer;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceData
+{
+    Instance uInstances[];
+};
+
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 3) uniform ShadowData
+{
+    mat4 uShadowMatrices[6];
+};
+
+// Cube face of every vertex. -1: taken from the instance and routed with gl_Layer (layered
+// framebuffer), otherwise the single face attached to the framebuffer.
+uniform int uFace;
+
+out vec4 FragPos;
+
+void main()
+{
+    Instance instance = uInstances[gl_BaseInstance + gl_InstanceID];
+    int face = uFace >= 0 ? uFace : instance.layer;
+    FragPos = instance.model * vec4(position, 1.0);
+    gl_Position = uShadowMatrices[face] * FragPos;
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+    gl_Layer = face;
+#endif
+}
@@ -2,8 +2,14 @@
 
 layout(location = 0) in vec3 a_Position;
 
-uniform mat4 u_Projection;
-uniform mat4 u_View;
+// std140 blocks shared by all programs, see src/UniformBuffer.h
+layout(std140, binding = 1) uniform ViewData
+{
+    mat4 uViewProjection;
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCamPos;
+};
 
 out vec3 v_LocalPos;
 
@@ -11,7 +17,7 @@ void main()
 {
     v_LocalPos = a_Position;
 
-    mat4 rotView = mat4(mat3(u_View)); // remove translation from the view matrix
-    vec4 clipPos = u_Projection * rotView * vec4(v_LocalPos, 1.0);
+    mat4 rotView = mat4(mat3(uView)); // remove translation from the view matrix
+    vec4 clipPos = uProjection * rotView * vec4(v_LocalPos, 1.0);
     gl_Position = clipPos.xyww;
 }
@@ -0,0 +1,116 @@
+#pragma once
+// Small harness shared by the headless benchmark targets: warmup, repeated timing,
+// ns/op and throughput, and a JSON report that can be diffed between runs.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Bench {
+	struct Result {
+		std::string name;
+		size_t items = 0;      // operations per repetition
+		int repeats = 0;
+		double nsPerOp = 0;    // median over the repetitions
+		double minNsPerOp = 0;
+		double opsPerSecond = 0;
+		double checksum = 0;   // keeps the work observable, also a cheap regression check
+	};
+
+	struct Options {
+		size_t size = 1 << 14;
+		int warmup = 3;
+		int repeats = 15;
+		std::string filter;
+		std::string json = "bench_math.json";
+
+		// false on --help, an unknown option or a missing value, after printing the usage
+		bool Parse(int argc, char** argv) {
+			for (int i = 1; i < argc; ++i) {
+				const char* option = argv[i];
+				const bool known = !strcmp(option, "--size") || !strcmp(option, "--warmup") || !strcmp(option, "--repeat")
+					|| !strcmp(option, "--filter") || !strcmp(option, "--json");
+				if (!known || i + 1 >= argc) {
+					if (strcmp(option, "--help")) std::printf(known ? "missing value for %s\n" : "unknown option %s\n", option);
+					PrintUsage(argv[0]);
+					return false;
+				}
+				const char* value = argv[++i];
+				if (!strcmp(option, "--size")) size = std::max<size_t>(4, std::strtoul(value, nullptr, 10));
+				else if (!strcmp(option, "--warmup")) warmup = std::atoi(value);
+				else if (!strcmp(option, "--repeat")) repeats = std::max(1, std::atoi(value));
+				else if (!strcmp(option, "--filter")) filter = value;
+				else json = value;
+			}
+			return true;
+		}
+
+		static void PrintUsage(const char* program) {
+			std::printf("usage: %s [--size N] [--warmup N] [--repeat N] [--filter name] [--json path]\n"
+				"  --json \"\" skips the report\n", program);
+		}
+	};
+
+	class Suite {
+	public:
+		explicit Suite(const Options& options) : mOptions(options) {}
+
+		// fn() runs `items` operations and returns a checksum of their results
+		template <typename Fn>
+		void Run(const std::string& name, size_t items, Fn&& fn) {
+			if (!mOptions.filter.empty() && name.find(mOptions.filter) == std::string::npos) return;
+
+			double checksum = 0;
+			for (int i = 0; i < mOptions.warmup; ++i)
+				checksum = fn();
+
+			std::vector<double> samples(mOptions.repeats);
+			for (double& sample : samples) {
+				auto start = std::chrono::steady_clock::now();
+				checksum = fn();
+				auto end = std::chrono::steady_clock::now();
+				sample = std::chrono::duration<double, std::nano>(end - start).count() / items;
+			}
+			std::sort(samples.begin(), samples.end());
+
+			Result result;
+			result.name = name;
+			result.items = items;
+			result.repeats = mOptions.repeats;
+			result.nsPerOp = samples[samples.size() / 2];
+			result.minNsPerOp = samples.front();
+			result.opsPerSecond = 1e9 / result.nsPerOp;
+			result.checksum = checksum;
+			std::printf("%-32s %10.2f ns/op %14.0f op/s  (min %.2f, checksum %g)\n", name.c_str(), result.nsPerOp, result.opsPerSecond, result.minNsPerOp, checksum);
+			mResults.push_back(result);
+		}
+
+		bool WriteJson(const char* backend) const {
+			if (mOptions.json.empty()) return true;
+			FILE* file = std::fopen(mOptions.json.c_str(), "w");
+			if (!file) {
+				std::printf("failed to open %s\n", mOptions.json.c_str());
+				return false;
+			}
+			std::fprintf(file, "{\n  \"backend\": \"%s\",\n  \"size\": %zu,\n  \"results\": [\n", backend, mOptions.size);
+			for (size_t i = 0; i < mResults.size(); ++i) {
+				const Result& r = mResults[i];
+				std::fprintf(file, "    { \"name\": \"%s\", \"items\": %zu, \"repeats\": %d, \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"ops_per_second\": %.1f, \"checksum\": %.9g }%s\n",
+					r.name.c_str(), r.items, r.repeats, r.nsPerOp, r.minNsPerOp, r.opsPerSecond, r.checksum, i + 1 < mResults.size() ? "," : "");
+			}
+			std::fprintf(file, "  ]\n}\n");
+			std::fclose(file);
+			std::printf("wrote %s\n", mOptions.json.c_str());
+			return true;
+		}
+
+		const Options& GetOptions() const { return mOptions; }
+
+	private:
+		Options mOptions;
+		std::vector<Result> mResults;
+	};
+}
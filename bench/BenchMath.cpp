@@ -0,0 +1,497 @@
+// Headless microbenchmarks of src/math.
+// Build with `xmake build bench_math` and run `xmake run bench_math [--size N] [--repeat N] [--filter name] [--json path]`.
+// Inputs come from a fixed seed, so the checksums in the JSON report only change when the math does.
+#include "Bench.h"
+#include "math/Matrix.h"
+#include "math/Geometry.h"
+#include "math/Bvh.h"
+#include "math/FastMath.h"
+#include "math/Packed.h"
+#include "math/Random.h"
+#include "math/Deterministic.h"
+
+#include <random>
+
+namespace {
+	// Keeps the optimizer from dropping the results
+	float Sink(const Matrix4& m) { return m[0][0] + m[1][1] + m[2][2] + m[3][3] + m[3][0]; }
+	float Sink(const Vector3& v) { return v.x + v.y + v.z; }
+	float Sink(const Quaternion& q) { return q.x + q.y + q.z + q.w; }
+
+	const char* Backend() {
+#if defined(MATH_SIMD_AVX)
+		return "avx";
+#elif defined(MATH_SIMD_SSE)
+		return "sse";
+#elif defined(MATH_SIMD_NEON)
+		return "neon";
+#else
+		return "scalar";
+#endif
+	}
+
+	struct Inputs {
+		std::vector<Matrix4> matrices, views, projections;
+		std::vector<Vector3> points, directions, scales;
+		std::vector<float> angles;
+		std::vector<Quaternion> rotations;
+
+		explicit Inputs(size_t size) : matrices(size), views(size), projections(size), points(size), directions(size), scales(size), angles(size), rotations(size) {
+			std::mt19937 rng(1234);
+			std::uniform_real_distribution<float> d(-10.0f, 10.0f);
+			for (size_t i = 0; i < size; ++i) {
+				// rigid transform plus a scale, always invertible
+				matrices[i] = Math::Translate(Matrix4::IDENTITY, Vector3(d(rng), d(rng), d(rng)));
+				matrices[i] = Math::Rotate(matrices[i], d(rng), Vector3(d(rng), d(rng), d(rng)) + Vector3(0, 0, 20.0f));
+				matrices[i] = Math::Scale(matrices[i], Vector3(1.0f) + Vector3(d(rng), d(rng), d(rng)) * 0.05f);
+				points[i] = Vector3(d(rng), d(rng), d(rng));
+				directions[i] = Math::Normalize(Vector3(d(rng), d(rng), d(rng)) + Vector3(0, 0, 20.0f));
+				scales[i] = Vector3(1.0f) + Vector3(d(rng), d(rng), d(rng)) * 0.05f;
+				angles[i] = d(rng);
+				rotations[i] = Quaternion(Vector3(d(rng), d(rng), d(rng)));
+				views[i] = Math::LookAt(points[i], points[i] + directions[i], Vector3(0, 1, 0));
+				projections[i] = Math::Perspective(Math::Radians(45.0f + angles[i]), 1.778f, 0.1f, 1000.0f);
+			}
+		}
+	};
+
+	// Scripted two-player session: every car steers towards a moving target, player 1 also
+	// uses the keys. Returns the hash of all car states after `ticks` simulation steps.
+	template <typename Scalar>
+	constexpr uint64_t ReplayChecksum(int ticks) {
+		CarState<Scalar> cars[5];
+		for (int i = 0; i < 5; ++i) cars[i].x = Scalar(i * 2 - 4);
+
+		for (int tick = 0; tick < ticks; ++tick) {
+			for (int i = 0; i < 5; ++i) {
+				cars[i].SteerTowards(Scalar((tick * 7 + i * 13) % 40 - 20), Scalar((tick * 3 + i * 29) % 30 - 15));
+				cars[i].Advance();
+			}
+			if (tick % 5 == 0) cars[0].Accelerate(Scalar(0.001f));
+			if (tick % 9 < 4) cars[0].Turn(Scalar(0.01f));
+		}
+
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (const CarState<Scalar>& car : cars)
+			hash = car.Hash(hash);
+		return hash;
+	}
+
+	// Every compiler has to agree with this value, it was produced by the reference build
+	constexpr int REPLAY_TICKS = 600;
+	static_assert(ReplayChecksum<Fixed>(REPLAY_TICKS) == 0x248ee296fb802fafull, "fixed-point simulation is not deterministic");
+
+	// The per-frame math of Engine::ShadowPass and Engine::MainPass
+	// the six cube face matrices of Engine::UpdateUniformBuffers
+	void ShadowMatrices(const Vector3& lightPos, Matrix4 (&shadowTransforms)[6]) {
+		Matrix4 shadowProj = Math::Perspective(Math::Radians(90.0f), 1.0f, 0.1f, 25.0f);
+		shadowTransforms[0] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0));
+		shadowTransforms[1] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(-1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0));
+		shadowTransforms[2] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(0.0, 1.0, 0.0), Vector3(0.0, 0.0, 1.0));
+		shadowTransforms[3] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(0.0, -1.0, 0.0), Vector3(0.0, 0.0, -1.0));
+		shadowTransforms[4] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(0.0, 0.0, 1.0), Vector3(0.0, -1.0, 0.0));
+		shadowTransforms[5] = shadowProj * Math::LookAt(lightPos, lightPos + Vector3(0.0, 0.0, -1.0), Vector3(0.0, -1.0, 0.0));
+	}
+
+	float FrameMath(const Vector3& lightPos, const Matrix4& projection, const Matrix4& view) {
+		Matrix4 shadowTransforms[6];
+		ShadowMatrices(lightPos, shadowTransforms);
+		float sum = Sink(projection * view);
+		for (const Matrix4& m : shadowTransforms)
+			sum += Sink(m);
+		return sum;
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::Options options;
+	if (!options.Parse(argc, argv)) return 2;
+	Bench::Suite suite(options);
+
+	const size_t n = options.size;
+	Inputs in(n);
+	std::vector<Matrix4> out(n);
+	const Vector4 viewport(0, 0, 800, 600);
+	std::printf("bench_math: backend %s, %zu elements per run\n", Backend(), n);
+
+	suite.Run("Math::Inverse(Matrix4)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::Inverse(in.matrices[i]));
+		return sum;
+	});
+	suite.Run("Math::InverseAffine", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::InverseAffine(in.matrices[i]));
+		return sum;
+	});
+	suite.Run("Math::Inverse(view)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::Inverse(in.views[i]));
+		return sum;
+	});
+	suite.Run("Math::InverseRigid", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::InverseRigid(in.views[i]));
+		return sum;
+	});
+	suite.Run("Math::InversePerspective", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::InversePerspective(in.projections[i]));
+		return sum;
+	});
+	suite.Run("Math::Transpose(Matrix4)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::Transpose(in.matrices[i]));
+		return sum;
+	});
+	suite.Run("Matrix4 * Matrix4", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(in.matrices[i] * in.matrices[n - 1 - i]);
+		return sum;
+	});
+	suite.Run("Math::LookAt", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::LookAt(in.points[i], in.points[i] + in.directions[i], Vector3(0, 1, 0)));
+		return sum;
+	});
+	suite.Run("Math::Perspective", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::Perspective(1.0f + in.angles[i] * 0.05f, 1.778f, 0.1f, 1000.0f));
+		return sum;
+	});
+	suite.Run("Quaternion(const Vector3&)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Quaternion(in.points[i]));
+		return sum;
+	});
+	suite.Run("Math::Rotate(Quaternion, Vector3)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) sum += Sink(Math::Rotate(in.rotations[i], in.points[i]));
+		return sum;
+	});
+	suite.Run("Math::Unproject", n, [&]() {
+		const Matrix4 projection = Math::Perspective(Math::Radians(45.0f), 1.333f, 0.1f, 1000.0f);
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) {
+			const Vector3 win((i % 800) + 0.5f, (i % 600) + 0.5f, (i % 97) / 97.0f);
+			sum += Sink(Math::Unproject(win, in.matrices[i], projection, viewport));
+		}
+		return sum;
+	});
+	// what Engine::OnEvent does now: the inverse view-projection is cached on the Camera
+	std::vector<Matrix4> inverseViewProjections(n);
+	for (size_t i = 0; i < n; ++i)
+		inverseViewProjections[i] = Math::InverseAffine(in.matrices[i]) * Math::InversePerspective(Math::Perspective(Math::Radians(45.0f), 1.333f, 0.1f, 1000.0f));
+	suite.Run("Math::Unproject(cached inverse)", n, [&]() {
+		float sum = 0;
+		for (size_t i = 0; i < n; ++i) {
+			const Vector3 win((i % 800) + 0.5f, (i % 600) + 0.5f, (i % 97) / 97.0f);
+			sum += Sink(Math::Unproject(win, inverseViewProjections[i], viewport));
+		}
+		return sum;
+	});
+	suite.Run("T * R * S per entity", n, [&]() {
+		for (size_t i = 0; i < n; ++i)
+			out[i] = Math::Translate(Matrix4::IDENTITY, in.points[i]) * Math::Rotate(Matrix4::IDENTITY, in.angles[i], Vector3(0, 1, 0)) * Math::Scale(Matrix4::IDENTITY, in.scales[i]);
+		return Sink(out[n / 2]);
+	});
+	suite.Run("Math::ComposeTRS", n, [&]() {
+		Math::ComposeTRS(in.points, in.angles, in.scales, out);
+		return Sink(out[n / 2]);
+	});
+
+	// math/FastMath.h: accuracy against libm in double with the limits documented there, then speed
+	std::vector<float> args(n), args2(n), sines(n), cosines(n), results(n);
+	bool accurate = true;
+	auto check = [&](const char* name, double error, double limit) {
+		std::printf("%-32s max error %.3g (limit %.3g)%s\n", name, error, limit, error <= limit ? "" : " FAILED");
+		accurate = accurate && error <= limit;
+	};
+	{
+		double sinError = 0, cosError = 0, atanError = 0, expError = 0, logError = 0;
+		for (size_t i = 0; i < n; ++i) args[i] = -8192.0f + 16384.0f * i / n;
+		Math::FastSinCos(args, sines, cosines);
+		for (size_t i = 0; i < n; ++i) {
+			sinError = std::max(sinError, std::abs(sines[i] - std::sin(double(args[i]))));
+			cosError = std::max(cosError, std::abs(cosines[i] - std::cos(double(args[i]))));
+		}
+		for (size_t i = 0; i < n; ++i) {
+			args[i] = Math::Sin(i * 0.37f) * (i % 7);
+			args2[i] = Math::Cos(i * 0.91f) * (i % 5);
+		}
+		Math::FastAtan2(args, args2, results);
+		for (size_t i = 0; i < n; ++i) atanError = std::max(atanError, std::abs(results[i] - std::atan2(double(args[i]), double(args2[i]))));
+		for (size_t i = 0; i < n; ++i) args[i] = -87.3f + (88.3f + 87.3f) * i / n;
+		Math::FastExp(args, results);
+		for (size_t i = 0; i < n; ++i) expError = std::max(expError, std::abs(results[i] / std::exp(double(args[i])) - 1.0));
+		// every exponent, mantissas spread over [1, 2)
+		for (size_t i = 0; i < n; ++i) args[i] = std::ldexp(1.0f + float(i % 509) / 509.0f, int(i % 254) - 126);
+		Math::FastLog(args, results);
+		for (size_t i = 0; i < n; ++i) {
+			const double expected = std::log(double(args[i]));
+			const double error = std::abs(results[i] - expected);
+			logError = std::max(logError, std::abs(expected) < 1.0 ? error : error / std::abs(expected));
+		}
+		check("FastSin", sinError, 1.0e-7);
+		check("FastCos", cosError, 1.0e-7);
+		check("FastAtan2", atanError, 2.5e-6);
+		check("FastExp", expError, 1.0e-7);
+		check("FastLog", logError, 1.0e-7);
+	}
+
+	// TransformStore::Update: normal matrices as ComposeTRS over 1 / scale instead of inverting each model matrix
+	std::vector<Vector3> inverseScales(n);
+	std::vector<Matrix4> normalMatrices(n);
+	for (size_t i = 0; i < n; ++i) inverseScales[i] = 1.0f / in.scales[i];
+	{
+		Math::ComposeTRS(in.points, in.angles, in.scales, out);
+		Math::ComposeTRS(in.points, in.angles, inverseScales, normalMatrices);
+		double normalError = 0;
+		for (size_t i = 0; i < n; ++i) {
+			const Matrix3 expected(Math::Transpose(Math::InverseAffine(out[i])));
+			const Matrix3 actual(normalMatrices[i]);
+			for (int c = 0; c < 3; ++c)
+				for (int r = 0; r < 3; ++r)
+					normalError = std::max(normalError, double(std::abs(actual[c][r] - expected[c][r])));
+		}
+		check("Normal matrix (1 / scale)", normalError, 1.0e-5);
+	}
+	suite.Run("normal matrices: InverseAffine", n, [&]() {
+		for (size_t i = 0; i < n; ++i)
+			normalMatrices[i] = Math::Transpose(Math::InverseAffine(out[i]));
+		return Sink(normalMatrices[n / 2]);
+	});
+	suite.Run("normal matrices: ComposeTRS(1 / scale)", n, [&]() {
+		for (size_t i = 0; i < n; ++i) inverseScales[i] = 1.0f / in.scales[i];
+		Math::ComposeTRS(in.points, in.angles, inverseScales, normalMatrices);
+		return Sink(normalMatrices[n / 2]);
+	});
+
+	for (size_t i = 0; i < n; ++i) {
+		args[i] = in.angles[i];
+		args2[i] = in.points[i].x;
+	}
+	suite.Run("Math::Sin + Math::Cos", n, [&]() {
+		for (size_t i = 0; i < n; ++i) {
+			sines[i] = Math::Sin(args[i]);
+			cosines[i] = Math::Cos(args[i]);
+		}
+		return sines[n / 2] + cosines[n / 3];
+	});
+	suite.Run("Math::FastSinCos(float)", n, [&]() {
+		for (size_t i = 0; i < n; ++i) Math::FastSinCos(args[i], sines[i], cosines[i]);
+		return sines[n / 2] + cosines[n / 3];
+	});
+	suite.Run("Math::FastSinCos(span)", n, [&]() {
+		Math::FastSinCos(args, sines, cosines);
+		return sines[n / 2] + cosines[n / 3];
+	});
+	suite.Run("Math::Atan2", n, [&]() {
+		for (size_t i = 0; i < n; ++i) results[i] = Math::Atan2(args[i], args2[i]);
+		return results[n / 2];
+	});
+	suite.Run("Math::FastAtan2(span)", n, [&]() {
+		Math::FastAtan2(args, args2, results);
+		return results[n / 2];
+	});
+	suite.Run("expf", n, [&]() {
+		for (size_t i = 0; i < n; ++i) results[i] = expf(args[i]);
+		return results[n / 2];
+	});
+	suite.Run("Math::FastExp(span)", n, [&]() {
+		Math::FastExp(args, results);
+		return results[n / 2];
+	});
+	for (float& a : args2) a = Math::Abs(a) + 0.01f;
+	suite.Run("Math::Log", n, [&]() {
+		for (size_t i = 0; i < n; ++i) results[i] = Math::Log(args2[i]);
+		return results[n / 2];
+	});
+	suite.Run("Math::FastLog(span)", n, [&]() {
+		Math::FastLog(args2, results);
+		return results[n / 2];
+	});
+
+	// math/Packed.h round trips: every half exactly, the rest within half a step of their encoding
+	{
+		int halfMismatches = 0;
+		for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+			const float v = float(Half::FromRaw(uint16_t(bits)));
+			if (v == v && Half(v).raw != bits) ++halfMismatches;
+		}
+		check("Half(float(h)) != h", halfMismatches, 0);
+
+		double halfError = 0, snormError = 0, unormError = 0, octError = 0;
+		for (size_t i = 0; i < n; ++i) {
+			const float v = in.points[i].x * 1000.0f; // normal range, no denormals
+			halfError = std::max(halfError, double(std::abs(float(Half(v)) - v) / std::abs(v)));
+			const float unit = in.directions[i].x;
+			snormError = std::max(snormError, double(std::abs(float(SNorm16(unit)) - unit)));
+			const Vector4 color(std::abs(in.directions[i].x), std::abs(in.directions[i].y), in.angles[i] * 0.05f + 0.5f, 1.0f);
+			unormError = std::max(unormError, double(Math::Length(Vector4(UNorm8x4(color)) - color)));
+			// chord length, the angle of a float dot product is too coarse at this size
+			octError = std::max(octError, double(Math::Length(Vector3(OctNormal(in.directions[i])) - in.directions[i])));
+		}
+		check("Half relative", halfError, 1.0 / 2048);
+		check("SNorm16", snormError, 0.51 / 32767); // half a step plus the rounding of the division
+		check("UNorm8x4 (4 channels)", unormError, 2.0 * 0.5 / 255); // sqrt(4) * half a step
+		check("OctNormal (0.01 deg chord)", octError, Math::Radians(0.01f));
+	}
+	std::vector<Half> halves(n);
+	for (size_t i = 0; i < n; ++i) args[i] = in.points[i].x * 100.0f;
+	suite.Run("Half(float) per element", n, [&]() {
+		for (size_t i = 0; i < n; ++i) halves[i] = Half(args[i]);
+		return float(halves[n / 2]);
+	});
+	suite.Run("Math::PackHalf", n, [&]() {
+		Math::PackHalf(args, halves);
+		return float(halves[n / 2]);
+	});
+	suite.Run("float(Half) per element", n, [&]() {
+		for (size_t i = 0; i < n; ++i) results[i] = float(halves[i]);
+		return results[n / 2];
+	});
+	suite.Run("Math::UnpackHalf", n, [&]() {
+		Math::UnpackHalf(halves, results);
+		return results[n / 2];
+	});
+	std::vector<OctNormal> normals(n);
+	suite.Run("OctNormal(Vector3)", n, [&]() {
+		for (size_t i = 0; i < n; ++i) normals[i] = OctNormal(in.directions[i]);
+		return float(normals[n / 2].u);
+	});
+
+	std::vector<float> randoms(n);
+	suite.Run("DefaultRNG::uniformUnit", n, [&]() {
+		DefaultRNG rng(42u);
+		for (float& r : randoms) r = rng.uniformUnit();
+		return randoms[n / 2];
+	});
+	suite.Run("Philox4x32::fillUniform", n, [&]() {
+		Philox4x32 rng(42, 0);
+		rng.fillUniform(randoms);
+		return randoms[n / 2];
+	});
+	suite.Run("Philox4x32::fillNormal", n, [&]() {
+		Philox4x32 rng(42, 0);
+		rng.fillNormal(randoms);
+		return randoms[n / 2];
+	});
+
+	// one box per point, the frustum and ray look along +Z where most of the points are
+	std::vector<AABB> boxes(n);
+	for (size_t i = 0; i < n; ++i) boxes[i] = AABB(in.points[i] - in.scales[i] * 0.5f, in.points[i] + in.scales[i] * 0.5f);
+	const Frustum frustum(Math::Perspective(Math::Radians(45.0f), 1.778f, 0.1f, 100.0f) * Math::LookAt(Vector3(0, 0, -15), Vector3::ZERO, Vector3(0, 1, 0)));
+	const Ray ray(Vector3(0, 0, -15), Math::Normalize(Vector3(0.01f, 0.02f, 1.0f)));
+	std::vector<uint8_t> visible(n);
+	suite.Run("Intersects(Frustum, AABB)", n, [&]() {
+		size_t count = 0;
+		for (size_t i = 0; i < n; ++i) count += Math::Intersects(frustum, boxes[i]);
+		return float(count);
+	});
+	suite.Run("Math::Cull(Frustum, AABBs)", n, [&]() { return float(Math::Cull(frustum, boxes, visible)); });
+	// what RenderQueue::Cull does per frame: mesh bounds to world space, then one batched test
+	const AABB meshBounds(Vector3(-0.5f), Vector3(0.5f));
+	std::vector<AABB> worldBounds(n);
+	suite.Run("world bounds + Math::Cull", n, [&]() {
+		for (size_t i = 0; i < n; ++i) worldBounds[i] = Math::Transform(meshBounds, in.matrices[i]);
+		return float(Math::Cull(frustum, worldBounds, visible));
+	});
+	suite.Run("Intersects(Ray, AABB)", n, [&]() {
+		float closest = Math::POS_INFINITY, t = 0;
+		for (size_t i = 0; i < n; ++i)
+			if (Math::Intersects(ray, boxes[i], t) && t < closest) closest = t;
+		return closest;
+	});
+	suite.Run("Math::Raycast(Ray, AABBs)", n, [&]() {
+		float t = 0;
+		return Math::Raycast(ray, boxes, t) >= 0 ? t : -1.0f;
+	});
+	// picking: one ray per direction from the frustum eye, the BVH must find the same box as the linear scan
+	Bvh bvh;
+	bvh.Build(boxes);
+	const size_t rays = 1024;
+	{
+		size_t mismatches = 0;
+		for (size_t i = 0; i < rays; ++i) {
+			const Ray r(Vector3(0, 0, -15), in.directions[i]);
+			float linearT = 0, bvhT = 0;
+			const int linear = Math::Raycast(r, boxes, linearT), tree = bvh.Raycast(r, bvhT);
+			mismatches += linear != tree && !(linear >= 0 && tree >= 0 && linearT == bvhT);
+		}
+		std::printf("Bvh::Raycast: %zu of %zu rays differ from Math::Raycast%s\n", mismatches, rays, mismatches ? " FAILED" : "");
+		accurate = accurate && mismatches == 0;
+	}
+	suite.Run("Bvh::Build", n, [&]() {
+		bvh.Build(boxes);
+		return float(bvh.Size());
+	});
+	suite.Run("Bvh::Refit", n, [&]() {
+		bvh.Refit(boxes);
+		return float(bvh.Size());
+	});
+	suite.Run("Math::Raycast(AABBs) per ray", rays, [&]() {
+		float sum = 0, t = 0;
+		for (size_t i = 0; i < rays; ++i) sum += Math::Raycast(Ray(Vector3(0, 0, -15), in.directions[i]), boxes, t) >= 0 ? t : 0.0f;
+		return sum;
+	});
+	suite.Run("Bvh::Raycast per ray", rays, [&]() {
+		float sum = 0, t = 0;
+		for (size_t i = 0; i < rays; ++i) sum += bvh.Raycast(Ray(Vector3(0, 0, -15), in.directions[i]), t) >= 0 ? t : 0.0f;
+		return sum;
+	});
+
+	// triangle i spans points 3i..3i+2 (the bench size is the number of vertices)
+	const size_t triangles = n / 3;
+	suite.Run("Intersects(Ray, triangle)", triangles, [&]() {
+		float closest = Math::POS_INFINITY, t = 0;
+		for (size_t i = 0; i < triangles; ++i)
+			if (Math::Intersects(ray, in.points[3 * i], in.points[3 * i + 1], in.points[3 * i + 2], t) && t < closest) closest = t;
+		return closest;
+	});
+	suite.Run("Math::Raycast(Ray, triangles)", triangles, [&]() {
+		float t = 0;
+		return Math::Raycast(ray, std::span<const Vector3>(in.points.data(), triangles * 3), t) >= 0 ? t : -1.0f;
+	});
+
+	// CPU cost of the caster routing of the layered shadow path, every box against the six cube
+	// faces of the light. The geometry shader path does no CPU work but rasterizes every caster in
+	// all six faces. The GPU time of both paths is measured in the game (HUD, F6 switches).
+	Matrix4 shadowTransforms[6];
+	ShadowMatrices(Vector3(0, 5, 0), shadowTransforms);
+	Frustum shadowFaces[6];
+	for (int face = 0; face < 6; ++face) shadowFaces[face] = Frustum(shadowTransforms[face]);
+	size_t routed = 0;
+	for (const Frustum& face : shadowFaces) routed += Math::Cull(face, boxes, visible);
+	std::printf("shadow routing: %.2f faces per caster (geometry shader path: 6)\n", double(routed) / n);
+	suite.Run("shadow caster routing (6 faces)", n, [&]() {
+		size_t count = 0;
+		for (const Frustum& face : shadowFaces) count += Math::Cull(face, boxes, visible);
+		return float(count);
+	});
+
+	const size_t frames = 1024;
+	suite.Run("frame math (Shadow+MainPass)", frames, [&]() {
+		const Matrix4 projection = Math::Perspective(Math::Radians(45.0f), 1.778f, 0.1f, 1000.0f);
+		float sum = 0;
+		for (size_t frame = 0; frame < frames; ++frame) {
+			const Vector3 lightPos(Math::Cos(frame * 0.01f) * 3.0f, 5.0f, Math::Sin(frame * 0.01f) * 3.0f);
+			const Matrix4 view = Math::LookAt(Vector3(0.0f, 2.0f, 8.0f), Vector3::ZERO, Vector3(0, 1, 0));
+			sum += FrameMath(lightPos, projection, view);
+		}
+		return sum;
+	});
+
+	// The runtime result must match the constant-evaluated one, whatever the backend and flags
+	volatile int replayTicks = REPLAY_TICKS; // not a constant, so the optimizer can't fold the replay
+	const int ticks = replayTicks;
+	const uint64_t replay = ReplayChecksum<Fixed>(ticks);
+	constexpr uint64_t expected = ReplayChecksum<Fixed>(REPLAY_TICKS);
+	const bool deterministic = replay == expected;
+	std::printf("fixed-point replay: %d ticks, hash %016llx (%s), float hash %016llx\n", ticks, (unsigned long long)replay,
+		deterministic ? "matches" : "MISMATCH", (unsigned long long)ReplayChecksum<float>(ticks));
+	suite.Run("CarState<Fixed> tick x5 cars", REPLAY_TICKS, [&]() { return float(ReplayChecksum<Fixed>(ticks) & 0xffff); });
+	suite.Run("CarState<float> tick x5 cars", REPLAY_TICKS, [&]() { return float(ReplayChecksum<float>(ticks) & 0xffff); });
+
+	return suite.WriteJson(Backend()) && deterministic && accurate ? 0 : 1;
+}
@@ -15,11 +15,20 @@ void Camera::UpdateProjection() {
 	auto v = Engine::GetEngine()->GetViewportSize();
 	mAspectRatio = v.x / v.y;
 	mProjection = Math::Perspective(Math::Radians(mFOV), mAspectRatio, mNearClip, mFarClip);
+	UpdateViewProjection();
 }
 
 void Camera::UpdateView() {
 	// mYaw = mPitch = 0.0f; // Lock the camera's rotation
 	mViewMatrix = Math::LookAt(mPosition, mPosition + GetForwardDirection(), GetUpDirection());
+	UpdateViewProjection();
+}
+
+void Camera::UpdateViewProjection() {
+	mViewProjection = mProjection * mViewMatrix;
+	// LookAt is a rigid transform, so neither inverse needs the general cofactor path
+	mInverseViewProjection = Math::InverseRigid(mViewMatrix) * Math::InversePerspective(mProjection);
+	mFrustum = Frustum(mViewProjection);
 }
 
 float Camera::RotationSpeed() const { return 0.8f; }
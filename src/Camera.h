@@ -1,6 +1,6 @@
 #pragma once
 #include "Defines.h"
-#include "math/Matrix.h"
+#include "math/Geometry.h"
 using CameraPtr = shared_ptr<class Camera>;
 
 class Camera {
@@ -20,7 +20,9 @@ public:
 	}
 
 	const Matrix4& GetViewMatrix() const { return mViewMatrix; }
-	Matrix4 GetViewProjection() const { return mProjection * mViewMatrix; }
+	const Matrix4& GetViewProjection() const { return mViewProjection; }
+	const Matrix4& GetInverseViewProjection() const { return mInverseViewProjection; }
+	const Frustum& GetFrustum() const { return mFrustum; }
 
 	Vector3 GetUpDirection() const;
 	Vector3 GetRightDirection() const;
@@ -44,6 +46,7 @@ public:
 private:
 	void UpdateProjection();
 	void UpdateView();
+	void UpdateViewProjection();
 
 	void MouseRotate(const Vector2& delta);
 	void MouseZoom(float delta);
@@ -57,6 +60,9 @@ private:
 	float mFOV = 45.0f, mAspectRatio = 1.778f, mNearClip = 0.1f, mFarClip = 1000.0f;
 
 	Matrix4 mViewMatrix;
+	// rebuilt whenever the view or the projection changes, the inverse is used for picking
+	Matrix4 mViewProjection, mInverseViewProjection;
+	Frustum mFrustum;
 	Vector3 mPosition = { 0.0f, 0.0f, 3.0f };
 
 	Vector2 mInitialMousePosition = { 0.0f, 0.0f };
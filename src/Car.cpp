@@ -2,70 +2,87 @@
 int Car::sNextID = 0;
 Car::Car(Vector3 pos)
 {
-	mTransform.mPosition = pos;
-	mModel = make_shared<Model>(mModelPath);
+	mTransform = TransformStore::Get().Add(pos);
+	mState.x = SimScalar(pos.x);
+	mState.z = SimScalar(pos.z);
+	SyncTransform();
+	// every car draws the same meshes, which is what lets them be instanced
+	mModel = ResourceManager::Get().GetModel(mModelPath);
 	mEntityID = sNextID++;
 }
 
-void Car::Draw(ShaderPtr shader)
+void Car::Submit(RenderQueue& queue, const ShaderPtr& shader)
 {
-	// slot must >= 4, the first 3 slots are used
-	glActiveTexture(GL_TEXTURE4);
-	glBindTexture(GL_TEXTURE_2D, mTexture->GetID());
-	shader->SetMat4("uModel", GetModelMatrix());
-	shader->SetInt("uEntityID", mEntityID);
-	shader->SetBool("uUseAlbedo", false);
-	shader->SetBool("uUseNormal", true);
-	shader->SetBool("uUseRoughness", true);
-	shader->SetFloat2("UVScale", Vector2::ONE);
-	if (mSelected) {
-		shader->SetFloat("uEmission", 1.0f);
-	}
-	for (auto mesh : mModel->GetMesh()) {
-		shader->SetFloat3("uAlbedo", mesh->mMaterial.Albedo);
-		shader->SetFloat("uMetallic", mesh->mMaterial.Metallic);
-		shader->SetFloat("uRoughness", mesh->mMaterial.Roughness);
-		if (!mSelected) shader->SetFloat("uEmission", mesh->mMaterial.Emission);
-
-		glBindVertexArray(mesh->VAO);
-		glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+	DrawPacket packet;
+	packet.shader = shader.get();
+	packet.model = &TransformStore::Get().GetModelMatrix(mTransform);
+	packet.normal = &TransformStore::Get().GetNormalMatrix(mTransform);
+	packet.entityID = mEntityID;
+	packet.skin = mSkin;
+	packet.emission = mSelected ? 1.0f : -1.0f;
+	for (auto& mesh : mModel->GetMesh()) {
+		packet.mesh = mesh.get();
+		packet.material.albedo = mesh->mMaterial.Albedo;
+		packet.material.metallic = mesh->mMaterial.Metallic;
+		packet.material.roughness = mesh->mMaterial.Roughness;
+		packet.material.emission = mesh->mMaterial.Emission;
+		queue.Submit(packet);
 	}
 }
 
 void Car::Update(float delta)
 {
-	mTransform.mPosition += mVelocity * GetForward();
+	mState.Advance();
+	SyncTransform();
 }
 
-Wall::Wall(const string& path)
+void Car::Accelerate(float amount)
+{
+	mState.Accelerate(SimScalar(amount));
+}
+
+void Car::Turn(float amount)
+{
+	mState.Turn(SimScalar(amount));
+	SyncTransform();
+}
+
+void Car::SteerTowards(const Vector2& targetXZ)
 {
-	mModel = make_shared<Model>(path);
+	mState.SteerTowards(SimScalar(targetXZ.x), SimScalar(targetXZ.y));
+	SyncTransform();
 }
 
-void Wall::Draw(ShaderPtr shader)
+void Car::SyncTransform()
 {
-	glActiveTexture(GL_TEXTURE4);
-	if (mAlbedoTexture) glBindTexture(GL_TEXTURE_2D, mAlbedoTexture->GetID());
-	glActiveTexture(GL_TEXTURE5);
-	if (mNormalTexture) glBindTexture(GL_TEXTURE_2D, mNormalTexture->GetID());
-	glActiveTexture(GL_TEXTURE6);
-	if (mRoughnessTexture) glBindTexture(GL_TEXTURE_2D, mRoughnessTexture->GetID());
+	TransformStore& transforms = TransformStore::Get();
+	transforms.Position(mTransform).x = float(mState.x);
+	transforms.Position(mTransform).z = float(mState.z);
+	transforms.Theta(mTransform) = float(mState.theta);
+}
 
+Wall::Wall(const string& path)
+{
+	mTransform = TransformStore::Get().Add();
+	mModel = ResourceManager::Get().GetModel(path);
+}
 
-	shader->SetMat4("uModel", GetModelMatrix());
-	shader->SetInt("uEntityID", -1);
-	shader->SetBool("uUseAlbedo", !mAlbedoTexture);
-	shader->SetBool("uUseNormal", !mNormalTexture);
-	shader->SetBool("uUseRoughness", !mRoughnessTexture);
-	shader->SetFloat2("UVScale", mUVScale);
-	for (auto mesh : mModel->GetMesh()) {
-		shader->SetFloat3("uAlbedo", mesh->mMaterial.Albedo);
-		shader->SetFloat("uMetallic", mesh->mMaterial.Metallic);
-		shader->SetFloat("uRoughness", mesh->mMaterial.Roughness);
-		shader->SetFloat("uEmission", mesh->mMaterial.Emission);
-		glBindVertexArray(mesh->VAO);
-		glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+void Wall::Submit(RenderQueue& queue, const ShaderPtr& shader)
+{
+	DrawPacket packet;
+	packet.shader = shader.get();
+	packet.model = &TransformStore::Get().GetModelMatrix(mTransform);
+	packet.normal = &TransformStore::Get().GetNormalMatrix(mTransform);
+	if (mAlbedoTexture) packet.material.albedoMap = mAlbedoTexture->GetID();
+	if (mNormalTexture) packet.material.normalMap = mNormalTexture->GetID();
+	if (mRoughnessTexture) packet.material.roughnessMap = mRoughnessTexture->GetID();
+	packet.material.uvScale = mUVScale;
+	packet.material.albedo = mMaterial.Albedo;
+	packet.material.metallic = mMaterial.Metallic;
+	packet.material.roughness = mMaterial.Roughness;
+	packet.material.emission = mMaterial.Emission;
+	for (auto& mesh : mModel->GetMesh()) {
+		packet.mesh = mesh.get();
+		queue.Submit(packet);
 	}
 }
@@ -2,45 +2,53 @@
 #include "Defines.h"
 #include "Model.h"
 #include "Shader.h"
+#include "RenderQueue.h"
+#include "ResourceManager.h"
+#include "TransformStore.h"
+#include "math/Deterministic.h"
 using CarPtr = shared_ptr<class Car>;
 using WallPtr = shared_ptr<class Wall>;
 
-class Transform {
-public:
-	Vector3 mPosition{ Vector3::ZERO };
-	Vector3 mScale{ Vector3::ONE };
-	float mTheta = 0; //-zļн
-
-	Transform() = default;
-
-	Matrix4 getMatrix() const {
-		Matrix4 temp = Math::Translate(Matrix4::IDENTITY, mPosition) * Math::Rotate(Matrix4::IDENTITY, mTheta,Vector3(0,1,0)) * Math::Scale(Matrix4::IDENTITY, mScale);
-		return temp;
-	}
-};
-
 class Car {
 public:
 	Car(Vector3 pos = Vector3(0));
+	~Car() { TransformStore::Get().Free(mTransform); }
+	// owns its TransformStore entry
+	Car(const Car&) = delete;
+	Car& operator=(const Car&) = delete;
 
-	void Draw(ShaderPtr shader);
+	// one packet per mesh
+	void Submit(RenderQueue& queue, const ShaderPtr& shader);
 
 	void Update(float delta);
+	// inputs go through the simulation state and are mirrored into the TransformStore for rendering
+	void Accelerate(float amount);
+	void Turn(float amount);
+	void SteerTowards(const Vector2& targetXZ);
 
-	Matrix4 GetModelMatrix() { return mTransform.getMatrix(); }
-	Vector3 GetForward() { return Vector3(-sin(mTransform.mTheta), 0, -cos(mTransform.mTheta)); }
+	const Matrix4& GetModelMatrix() const { return TransformStore::Get().GetModelMatrix(mTransform); }
+	Vector3 GetForward() {
+		float s = 0, c = 0;
+		Math::FastSinCos(TransformStore::Get().Theta(mTransform), s, c);
+		return Vector3(-s, 0, -c);
+	}
 	Vector3 GetRight() { return Math::Cross(GetForward(), GetUp()); }
 	Vector3 GetUp() { return Vector3(0, 1, 0); }
 
+	// layers of Engine's skin array
+	enum Skin { DefaultSkin, Player1Skin, Player2Skin };
+
 	ModelPtr mModel;
-	Texture2DPtr mTexture;
+	Skin mSkin = DefaultSkin;
 	int mEntityID;
 	bool mSelected = false;
-	Transform mTransform;
-	float mVelocity = 0;
+	uint32_t mTransform; // TransformStore index
+	CarState<SimScalar> mState;
 
 
 private:
+	void SyncTransform();
+
 	const string mModelPath = "asset/model/car.obj";
 	static int sNextID;
 };
@@ -49,12 +57,17 @@ private:
 class Wall {
 public:
 	Wall(const string& path);
+	~Wall() { TransformStore::Get().Free(mTransform); }
+	Wall(const Wall&) = delete;
+	Wall& operator=(const Wall&) = delete;
 
-	void Draw(ShaderPtr shader);
-	Matrix4 GetModelMatrix() { return mTransform.getMatrix(); }
+	void Submit(RenderQueue& queue, const ShaderPtr& shader);
+	const Matrix4& GetModelMatrix() const { return TransformStore::Get().GetModelMatrix(mTransform); }
 
-	Transform mTransform;
+	uint32_t mTransform; // TransformStore index
 	Vector2 mUVScale = Vector2(1, 1);
+	// the cube model is shared, so the material is set here instead of on its meshes
+	Mesh::Material mMaterial;
 	ModelPtr mModel;
 	Texture2DPtr mAlbedoTexture, mNormalTexture, mRoughnessTexture;
 };
@@ -0,0 +1,39 @@
+#include "DynamicResolution.h"
+#include "math/Math.h"
+
+// down to a multiple of sStep, the epsilon keeps 0.95 / 0.05 from flooring to 18
+static float Quantize(float scale)
+{
+	return std::floor(scale / DynamicResolution::sStep + 1e-3f) * DynamicResolution::sStep;
+}
+
+bool DynamicResolution::Update(float scaledMs, float fixedMs)
+{
+	if (!mEnabled || scaledMs <= 0.0f) return false;
+	if (mSettle > 0)
+	{
+		--mSettle;
+		return false;
+	}
+
+	// stay between 75% and 100% of the budget, only leave that band with a whole step
+	const float available = Math::Max(mBudget - fixedMs, mBudget * 0.1f);
+	float target = mScale;
+	if (scaledMs > available)
+		target = Quantize(mScale * Math::Sqrt(available / scaledMs));
+	else if (scaledMs < available * 0.75f)
+		target = Quantize(mScale * Math::Sqrt(available * 0.9f / scaledMs));
+	target = Math::Clamp(target, sMinScale, sMaxScale);
+	if (Math::Abs(target - mScale) < sStep * 0.5f) return false;
+
+	mScale = target;
+	mSettle = sSettleFrames;
+	return true;
+}
+
+void DynamicResolution::SetEnabled(bool enabled)
+{
+	mEnabled = enabled;
+	mSettle = sSettleFrames;
+	if (!enabled) mScale = sMaxScale;
+}
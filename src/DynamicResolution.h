@@ -0,0 +1,29 @@
+#pragma once
+#include "Defines.h"
+
+// Chooses the render scale of the main pass from its measured GPU time and a frame budget. The
+// scene target keeps the window size and only the viewport shrinks, so a new scale never
+// reallocates anything. Pixel cost goes with scale^2, so the scale moves by the square root of
+// the budget ratio, in steps of sStep, and waits a few frames after each change for the GPU timer
+// to settle.
+class DynamicResolution {
+public:
+	static constexpr float sMinScale = 0.5f, sMaxScale = 1.0f, sStep = 0.05f;
+
+	// scaledMs: GPU time of the passes that follow the scale, fixedMs: the rest of the frame.
+	// Returns true when the scale changed, the caller should then restart its timers.
+	bool Update(float scaledMs, float fixedMs);
+
+	float GetScale() const { return mScale; }
+	float GetBudget() const { return mBudget; }
+	void SetBudget(float milliseconds) { mBudget = milliseconds; }
+	bool IsEnabled() const { return mEnabled; }
+	// disabling goes back to full resolution
+	void SetEnabled(bool enabled);
+private:
+	static constexpr int sSettleFrames = 10;
+	bool mEnabled = true;
+	float mBudget = 1000.0f / 60.0f;
+	float mScale = sMaxScale;
+	int mSettle = sSettleFrames;
+};
@@ -1,5 +1,12 @@
 #include "Engine.h"
 Engine* Engine::sInstance = nullptr;
+
+static const char* ShadowModeName(Engine::ShadowMode mode)
+{
+	static const char* names[] = { "geometry shader", "layered", "per face" };
+	return names[int(mode)];
+}
+
 void APIENTRY glDebugOutput(GLenum source, GLenum type, unsigned int id, GLenum severity, GLsizei length, const char* message,
 	const void* userParam) {
 	if (id == 131169 || id == 131185 || id == 131218 || id == 131204) return;  // ignore these non-significant error codes
@@ -97,8 +104,9 @@ Engine::~Engine()
 void Engine::Init()
 {
 	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	// the shaders are #version 460, multi-draw indirect and storage buffers need at least 4.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 	mWindow = glfwCreateWindow(mWidth, mHeight, "Game", nullptr, nullptr);
@@ -125,6 +133,10 @@ void Engine::Init()
 		GetEngine()->OnMouseScroll(yoffset);
 		});
 
+	glfwSetKeyCallback(mWindow, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
+		if (action == GLFW_PRESS) GetEngine()->OnKeyPress(key);
+		});
+
 	glfwSetMouseButtonCallback(mWindow, [](GLFWwindow* window, int button, int action, int mods) {
 		switch (action) {
 		case GLFW_PRESS: {
@@ -148,6 +160,15 @@ void Engine::Init()
 		glDebugMessageControl(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR, GL_DEBUG_SEVERITY_HIGH, 0, nullptr, GL_TRUE);
 	}
 
+	GLint extensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+	for (GLint i = 0; i < extensions; ++i)
+	{
+		const std::string_view name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if (name == "GL_ARB_shader_viewport_layer_array" || name == "GL_AMD_vertex_shader_layer") mVertexShaderLayer = true;
+	}
+	mShadowMode = mVertexShaderLayer ? ShadowMode::Layered : ShadowMode::PerFace;
+
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_DEPTH_TEST);
@@ -157,6 +178,9 @@ void Engine::Init()
 	PrepareScene();
 
 	mTextRenderer = make_shared<class TextRenderer>(mWidth, mHeight);
+
+	const auto& stats = ResourceManager::Get().GetStats();
+	INFO("Resources: {} requests, {} loaded, {} shared", stats.requests, stats.loads, stats.hits);
 }
 
 void Engine::Clear()
@@ -178,10 +202,17 @@ void Engine::Run()
 		lastFrame = currentFrame;
 		UpdateScene(deltaTime);
 
+		mReadback.Poll();
 		OnEvent();
+		UpdateTransforms();
+		UpdateRenderSize();
+		UpdateUniformBuffers(currentFrame, deltaTime);
 
+		mShadowStats = {};
+		mMainStats = {};
 		ShadowPass();
 		MainPass();
+		PickPass();
 
 		glfwSwapBuffers(mWindow);
 		glfwPollEvents();
@@ -226,26 +257,14 @@ void Engine::OnMouseRelease(int button)
 		mIsPressed["left"] = false;
 		if (!mPlay)
 		{
-			int id = ReadPixel();
-			if (id >= 0) //idΪ-1
-			{
-				INFO("Selece car with id {}", id);
-				if (mPlayer1.mCarID == -1)  mPlayer1.mCarID = id;
-				else if (mPlayer2.mCarID == -1)  mPlayer2.mCarID = id;
-			}
-			else { //ѡ ճѡ
-				INFO("Deselect");
-				mPlayer1.mCarID = -1;
-				mPlayer2.mCarID = -1;
-			}
-
-			for (auto& car : mCars)
+			auto pos = GetMousePosition();
+			if (mPickOnGpu)
 			{
-				if (car->mEntityID == mPlayer1.mCarID) car->mTexture = mPlayer1Texture;
-				else if (car->mEntityID == mPlayer2.mCarID) car->mTexture = mPlayer2Texture;
-				else car->mTexture = mDefaultTexture;
-				car->mSelected = car->mEntityID == mPlayer1.mCarID || car->mEntityID == mPlayer2.mCarID;
+				RequestPick(pos.first, pos.second, [this](int id) {
+					if (!mPlay) SelectCar(id);
+				});
 			}
+			else SelectCar(Pick(pos.first, pos.second).entityID);
 		}
 	}
 	if (button == 1) // right
@@ -255,44 +274,82 @@ void Engine::OnMouseRelease(int button)
 	}
 }
 
+void Engine::SelectCar(int id)
+{
+	if (id >= 0) //idΪ-1
+	{
+		INFO("Selece car with id {}", id);
+		if (mPlayer1.mCarID == -1)  mPlayer1.mCarID = id;
+		else if (mPlayer2.mCarID == -1)  mPlayer2.mCarID = id;
+	}
+	else { //ѡ ճѡ
+		INFO("Deselect");
+		mPlayer1.mCarID = -1;
+		mPlayer2.mCarID = -1;
+	}
+
+	for (auto& car : mCars)
+	{
+		if (car->mEntityID == mPlayer1.mCarID) car->mSkin = Car::Player1Skin;
+		else if (car->mEntityID == mPlayer2.mCarID) car->mSkin = Car::Player2Skin;
+		else car->mSkin = Car::DefaultSkin;
+		car->mSelected = car->mEntityID == mPlayer1.mCarID || car->mEntityID == mPlayer2.mCarID;
+	}
+}
+
+void Engine::OnKeyPress(int key)
+{
+	if (key == GLFW_KEY_F6)
+	{
+		INFO("Shadow pass ({}): {:.3f} ms per full redraw", ShadowModeName(mShadowMode), mShadowModeTimers[int(mShadowMode)].GetMilliseconds());
+		do {
+			mShadowMode = ShadowMode((int(mShadowMode) + 1) % 3);
+		} while (mShadowMode == ShadowMode::Layered && !mVertexShaderLayer);
+		mShadowTimer.Reset();
+		InvalidateStaticShadows();
+	}
+	if (key == GLFW_KEY_F9)
+	{
+		mDynamicResolution.SetEnabled(!mDynamicResolution.IsEnabled());
+		mMainTimer.Reset();
+	}
+	if (key == GLFW_KEY_F8)
+	{
+		mPickOnGpu = !mPickOnGpu;
+	}
+	if (key == GLFW_KEY_F7)
+	{
+		mShadowTaps = mShadowTaps == 16 ? 1 : mShadowTaps == 1 ? 4 : mShadowTaps * 2;
+		mSceneTimer.Reset();
+	}
+}
+
 void Engine::OnEvent()
 {
 	if (mIsPressed["left"])
 	{
 		if (mPlay && mPlayer2.mCarID >= 0) // Player2 ٿ
 		{
-			CarPtr car = mCars[mPlayer2.mCarID];
 			auto pos = GetMousePosition();
-			float depth = ReadDepth();
-
-			Vector2 mousePosWorld;
+			if (mPickOnGpu)
 			{
-				Vector3 winPos = Vector3(pos.first, mHeight - pos.second, depth);
-				auto posWorld = Math::Unproject(winPos, mCamera->GetViewMatrix(), mCamera->GetProjection(), Vector4(0, 0, mWidth, mHeight));
-				mousePosWorld = Vector2(posWorld.x, posWorld.z);
+				// exact point on the surface under the cursor, a frame or two late
+				if (!mSteerPending)
+				{
+					mSteerPending = RequestPickPosition(pos.first, pos.second, [this, id = mPlayer2.mCarID](bool hit, Vector3 position) {
+						mSteerPending = false;
+						if (hit && mPlay && mPlayer2.mCarID == id)
+							mCars[id]->SteerTowards(Vector2(position.x, position.z));
+					});
+				}
 			}
-			Vector2 carPosWorld = Vector2(car->mTransform.mPosition.x, car->mTransform.mPosition.z);
-			Vector2 delta = mousePosWorld - carPosWorld;
-
-			float dis = Math::Length(delta);
-			float angle = atan2(-delta.x, -delta.y);
-
-			// car->mTransform.mTheta = angle;
-			float theta = angle - car->mTransform.mTheta;
-			if (theta > -Math::PI && theta < Math::PI) {
-				car->mTransform.mTheta += theta * 0.05f;
-			}
-			else if (theta < -Math::PI) {
-				car->mTransform.mTheta += (2 * Math::PI + theta) * 0.05f;
-			}
-			else if (theta > Math::PI) {
-				car->mTransform.mTheta += (theta - 2 * Math::PI) * 0.05f;
-			}
-			car->mTransform.mTheta = fmod(car->mTransform.mTheta, Math::PI * 2);
-
+			else
 			{
-				float speed_change = Math::Clamp(log(dis), 0, 1) * 0.1f;
-				car->mVelocity += (speed_change - car->mVelocity) * 0.1f;
+				// the BVH only knows bounds: the target is where the ray enters the box, which for the
+				// flat ground matches the surface and is close enough on walls and cars
+				PickResult pick = Pick(pos.first, pos.second);
+				if (pick.hit)
+					mCars[mPlayer2.mCarID]->SteerTowards(Vector2(pick.position.x, pick.position.z));
 			}
 		}
 	}
@@ -327,13 +384,13 @@ void Engine::OnEvent()
 			CarPtr car = mCars[mPlayer1.mCarID];
 			float mspeed = 0.001f, rspeed = 0.01f;
 			if (glfwGetKey(mWindow, GLFW_KEY_UP) == GLFW_PRESS)
-				car->mVelocity += mspeed;
+				car->Accelerate(mspeed);
 			if (glfwGetKey(mWindow, GLFW_KEY_DOWN) == GLFW_PRESS)
-				car->mVelocity -= mspeed;
+				car->Accelerate(-mspeed);
 			if (glfwGetKey(mWindow, GLFW_KEY_LEFT) == GLFW_PRESS)
-				car->mTransform.mTheta += rspeed;
+				car->Turn(rspeed);
 			if (glfwGetKey(mWindow, GLFW_KEY_RIGHT) == GLFW_PRESS)
-				car->mTransform.mTheta -= rspeed;
+				car->Turn(-rspeed);
 		}
 	}
 
@@ -343,8 +400,7 @@ void Engine::UpdateScene(GLfloat delta)
 {
 	if (!mPlay) return;
 
-	mLightPos.x = cos(glfwGetTime() * 0.5) * 3.0;
-	mLightPos.z = sin(glfwGetTime() * 0.5) * 3.0;
+	SetLightPosition(Vector3(cos(glfwGetTime() * 0.5) * 3.0, mLightPos.y, sin(glfwGetTime() * 0.5) * 3.0));
 
 	for (auto& car : mCars)
 	{
@@ -353,102 +409,306 @@ void Engine::UpdateScene(GLfloat delta)
 
 }
 
-void Engine::ShadowPass()
+void Engine::UpdateTransforms()
 {
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	TransformStore::Get().Update();
 
-	GLfloat aspect = (GLfloat)mShadowMapWidth / (GLfloat)mShadowMapHeight;
-	GLfloat near = 0.1f;
-	GLfloat far = 25.0f;
-	Matrix4 shadowProj = Math::Perspective(Math::Radians(90.0f), aspect, near, far);
-	std::vector<Matrix4> shadowTransforms;
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0)));
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(-1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0)));
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 1.0, 0.0), Vector3(0.0, 0.0, 1.0)));
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, -1.0, 0.0), Vector3(0.0, 0.0, -1.0)));
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 0.0, 1.0), Vector3(0.0, -1.0, 0.0)));
-	shadowTransforms.push_back(shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 0.0, -1.0), Vector3(0.0, -1.0, 0.0)));
+	// picking goes through the ID pass by default, the BVH is brought up to date only when Pick needs it
+	mPickBvhDirty = true;
+}
 
-	glViewport(0, 0, mShadowMapWidth, mShadowMapHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, mShadowFBO);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	mShadowShader->Use();
-	for (GLuint i = 0; i < 6; ++i)
-		mShadowShader->SetMat4("shadowMatrices[" + std::to_string(i) + "]", shadowTransforms[i]);
-	mShadowShader->SetFloat3("uLightPos", mLightPos);
-	mShadowShader->SetFloat("uFarPlane", far);
+void Engine::UpdatePickBvh()
+{
+	if (!mPickBvhDirty) return;
+	mPickBvhDirty = false;
 
+	mPickBounds.clear();
+	mPickEntities.clear();
 	for (auto& car : mCars)
 	{
-		car->Draw(mShadowShader);
+		for (auto& mesh : car->mModel->GetMesh())
+		{
+			mPickBounds.push_back(Math::Transform(mesh->mBounds, car->GetModelMatrix()));
+			mPickEntities.push_back(car->mEntityID);
+		}
 	}
 	for (auto& wall : mWalls)
 	{
-		wall->Draw(mShadowShader);
+		for (auto& mesh : wall->mModel->GetMesh())
+		{
+			mPickBounds.push_back(Math::Transform(mesh->mBounds, wall->GetModelMatrix()));
+			mPickEntities.push_back(-1);
+		}
 	}
+	// the cars only move a little per frame, keeping the tree and refitting the bounds is enough
+	if (mPickBvh.Size() == mPickBounds.size()) mPickBvh.Refit(mPickBounds);
+	else mPickBvh.Build(mPickBounds);
+}
+
+void Engine::UpdateRenderSize()
+{
+	// the shadow pass does not depend on the resolution, it is the fixed part of the budget
+	if (mDynamicResolution.Update(mMainTimer.GetMilliseconds(), mShadowTimer.GetMilliseconds()))
+		mMainTimer.Reset();
+	const float scale = mDynamicResolution.GetScale();
+	mRenderWidth = std::max<size_t>(1, size_t(mWidth * scale + 0.5f));
+	mRenderHeight = std::max<size_t>(1, size_t(mHeight * scale + 0.5f));
+}
+
+void Engine::UpdateUniformBuffers(GLfloat time, GLfloat delta)
+{
+	FrameData frame{};
+	frame.uTime = time;
+	frame.uDeltaTime = delta;
+	frame.uViewportSize = Vector2(mRenderWidth, mRenderHeight);
+	mFrameUBO->Update(frame);
+
+	ViewData view{};
+	view.uViewProjection = mCamera->GetViewProjection();
+	view.uView = mCamera->GetViewMatrix();
+	view.uProjection = mCamera->GetProjection();
+	view.uCamPos = mCamera->GetPosition();
+	mViewUBO->Update(view);
+
+	LightData light{};
+	light.uLightPos = mLightPos;
+	light.uFarPlane = mShadowFarPlane;
+	light.uShadowTaps = mShadowTaps;
+	mLightUBO->Update(light);
+
+	GLfloat aspect = (GLfloat)mShadowMapWidth / (GLfloat)mShadowMapHeight;
+	Matrix4 shadowProj = Math::Perspective(Math::Radians(90.0f), aspect, 0.1f, mShadowFarPlane);
+	ShadowData shadow{};
+	shadow.uShadowMatrices[0] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0));
+	shadow.uShadowMatrices[1] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(-1.0, 0.0, 0.0), Vector3(0.0, -1.0, 0.0));
+	shadow.uShadowMatrices[2] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 1.0, 0.0), Vector3(0.0, 0.0, 1.0));
+	shadow.uShadowMatrices[3] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, -1.0, 0.0), Vector3(0.0, 0.0, -1.0));
+	shadow.uShadowMatrices[4] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 0.0, 1.0), Vector3(0.0, -1.0, 0.0));
+	shadow.uShadowMatrices[5] = shadowProj * Math::LookAt(mLightPos, mLightPos + Vector3(0.0, 0.0, -1.0), Vector3(0.0, -1.0, 0.0));
+	mShadowUBO->Update(shadow);
+	for (int face = 0; face < 6; ++face)
+		mShadowFrusta[face] = Frustum(shadow.uShadowMatrices[face]);
+
+	// every program reads these blocks from the same binding points, bind them once for the frame
+	mFrameUBO->Bind();
+	mViewUBO->Bind();
+	mLightUBO->Bind();
+	mShadowUBO->Bind();
+}
+
+void Engine::SubmitShadowCasters(const ShaderPtr& shader, bool dynamic)
+{
+	mShadowQueue.Reset(mLightPos);
+	if (dynamic)
+	{
+		for (auto& car : mCars)
+		{
+			car->Submit(mShadowQueue, shader);
+		}
+	}
+	else
+	{
+		for (auto& wall : mWalls)
+		{
+			wall->Submit(mShadowQueue, shader);
+		}
+	}
+}
+
+// Draws the cars (dynamic) or the walls into the depth cube attached to the bound framebuffer
+void Engine::DrawShadowCasters(GLuint cubeMap, bool dynamic)
+{
+	switch (mShadowMode)
+	{
+	case ShadowMode::GeometryShader:
+		mShadowQueue.SetLayers({});
+		SubmitShadowCasters(mShadowShader, dynamic);
+		mShadowStats += mShadowQueue.Flush();
+		break;
+	case ShadowMode::Layered:
+		mShadowQueue.SetLayers(mShadowFrusta);
+		SubmitShadowCasters(mLayeredShadowShader, dynamic);
+		mLayeredShadowShader->Use();
+		mLayeredShadowShader->SetInt("uFace", -1);
+		mShadowStats += mShadowQueue.Flush();
+		break;
+	case ShadowMode::PerFace:
+		for (int face = 0; face < 6; ++face)
+		{
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, cubeMap, 0);
+			mShadowQueue.SetLayers({ &mShadowFrusta[face], 1 });
+			SubmitShadowCasters(mLayeredShadowShader, dynamic);
+			mLayeredShadowShader->Use();
+			mLayeredShadowShader->SetInt("uFace", face);
+			mShadowStats += mShadowQueue.Flush();
+		}
+		// back to the layered attachment the other modes render into
+		glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cubeMap, 0);
+		break;
+	}
+}
+
+void Engine::ShadowPass()
+{
+	bool carsMoved = mShadowCarMatrices.size() != mCars.size();
+	for (size_t i = 0; i < mCars.size() && !carsMoved; ++i)
+		carsMoved = memcmp(&mShadowCarMatrices[i], &mCars[i]->GetModelMatrix(), sizeof(Matrix4)) != 0;
+
+	mShadowTimer.Begin();
+	if (!mStaticShadowDirty && !carsMoved)
+	{
+		// paused: mShadowMap still holds last frame's depth
+		mShadowUpdate = "cached";
+		mShadowTimer.End();
+		return;
+	}
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glViewport(0, 0, mShadowMapWidth, mShadowMapHeight);
+
+	mShadowUpdate = "cars";
+	const bool redrawStatic = mStaticShadowDirty;
+	GpuTimer& modeTimer = mShadowModeTimers[int(mShadowMode)];
+	if (redrawStatic)
+	{
+		modeTimer.Begin();
+		glBindFramebuffer(GL_FRAMEBUFFER, mStaticShadowFBO);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		DrawShadowCasters(mStaticShadowMap, false);
+		mStaticShadowDirty = false;
+		mShadowUpdate = "walls + cars";
+	}
+
+	// start from the static depth and draw the cars on top
+	glCopyImageSubData(mStaticShadowMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+		mShadowMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0, mShadowMapWidth, mShadowMapHeight, 6);
+	glBindFramebuffer(GL_FRAMEBUFFER, mShadowFBO);
+	DrawShadowCasters(mShadowMap, true);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (redrawStatic) modeTimer.End();
+
+	mShadowCarMatrices.resize(mCars.size());
+	for (size_t i = 0; i < mCars.size(); ++i)
+		mShadowCarMatrices[i] = mCars[i]->GetModelMatrix();
+	mShadowTimer.End();
 }
 
-void Engine::MainPass()
+void Engine::PickPass()
 {
+	if (mPickRequests.empty()) return;
+
+	// a few pixels around each cursor position, the rest of the target is never touched
+	const GLint radius = 2, noEntity = -1;
+	glBindFramebuffer(GL_FRAMEBUFFER, mPickFBO);
 	glViewport(0, 0, mWidth, mHeight);
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glDisable(GL_BLEND);
+	glEnable(GL_SCISSOR_TEST);
+
+	mPickQueue.SetLayers({ &mCamera->GetFrustum(), 1 });
+	for (auto& request : mPickRequests)
+	{
+		glScissor(request.x - radius, request.y - radius, 2 * radius + 1, 2 * radius + 1);
+		glClearBufferiv(GL_COLOR, 0, &noEntity);
+		glClear(GL_DEPTH_BUFFER_BIT);
+
+		mPickQueue.Reset(mCamera->GetPosition());
+		for (auto& car : mCars)
+		{
+			car->Submit(mPickQueue, mPickShader);
+		}
+		for (auto& wall : mWalls)
+		{
+			wall->Submit(mPickQueue, mPickShader);
+		}
+		mPickQueue.Flush();
+
+		if (request.callback)
+			mReadback.Request(mPickFBO, GL_COLOR_ATTACHMENT0, request.x, request.y, int(mWidth), int(mHeight), GL_RED_INTEGER, GL_INT, std::move(request.callback));
+		if (request.positionCallback)
+		{
+			// unprojected with the camera this pass was drawn with, not the one current at delivery
+			const Matrix4 inverseViewProjection = mCamera->GetInverseViewProjection();
+			const Vector4 viewport(0, 0, mWidth, mHeight);
+			const Vector2 pixel(request.x + 0.5f, request.y + 0.5f);
+			mReadback.Request<float>(mPickFBO, GL_DEPTH_ATTACHMENT, request.x, request.y, int(mWidth), int(mHeight), GL_DEPTH_COMPONENT, GL_FLOAT,
+				[inverseViewProjection, viewport, pixel, callback = std::move(request.positionCallback)](float depth) {
+					if (depth >= 1.0f) callback(false, Vector3());
+					else callback(true, Math::Unproject(Vector3(pixel.x, pixel.y, depth), inverseViewProjection, viewport));
+				});
+		}
+	}
+	mPickRequests.clear();
+
+	glDisable(GL_SCISSOR_TEST);
+	glEnable(GL_BLEND);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Engine::MainPass()
+{
+	// mMainFBO has the window size, dynamic resolution only renders into its lower left corner
+	glViewport(0, 0, mRenderWidth, mRenderHeight);
 
 	// Draw scene
 	glBindFramebuffer(GL_FRAMEBUFFER, mMainFBO);
+	mMainTimer.Begin();
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
 
 	glClearColor(0.1f, 0.5f, 0.7f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	mMainShader->Use();
-	mMainShader->SetMat4("uViewProjection", mCamera->GetViewProjection());
-	mMainShader->SetFloat3("uCamPos", mCamera->GetPosition());
-	mMainShader->SetFloat("uFarPlane", 25.0f); // shadow far plane
-	mMainShader->SetFloat3("uLightPos", mLightPos);
-
 	mLUT->Bind(0);
 	mEnvironment.GetRadiance()->Bind(1);
 	mEnvironment.GetIrradiance()->Bind(2);
 
 	glActiveTexture(GL_TEXTURE3);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, mShadowMap);
+	mCarSkins->Bind(RenderQueue::sSkinUnit);
 
+	mSceneTimer.Begin();
+	mMainQueue.SetLayers({ &mCamera->GetFrustum(), 1 });
+	mMainQueue.Reset(mCamera->GetPosition());
 	for (auto& car : mCars)
 	{
-		car->Draw(mMainShader);
+		car->Submit(mMainQueue, mMainShader);
 	}
 
 	for (auto& wall : mWalls)
 	{
-		wall->Draw(mMainShader);
+		wall->Submit(mMainQueue, mMainShader);
 	}
+	mMainStats = mMainQueue.Flush();
+	mSceneTimer.End();
 	// Skybox 
 	{
 		glDepthFunc(GL_LEQUAL);
 		mSkyboxShader->Use();
 		mSkyboxShader->SetInt("u_SkyboxTexture", 0);
-		mSkyboxShader->SetMat4("u_Projection", mCamera->GetProjection());
-		mSkyboxShader->SetMat4("u_View", mCamera->GetViewMatrix());
 		mEnvironment.GetIrradiance()->Bind(0);
 
-		for (auto mesh : mCube->GetMesh()) {
-			glBindVertexArray(mesh->VAO);
-			glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-			glBindVertexArray(0);
-		}
+		for (auto& mesh : mCube->GetMesh())
+			mesh->Draw();
 		glDepthFunc(GL_LESS);
 	}
+	mMainTimer.End();
 
 	// Present to screen 
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, mWidth, mHeight);
 		glDisable(GL_DEPTH_TEST);
 
 		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 		mPresentShader->Use();
+		// bilinear upsampling of the rendered part of the scene target
+		mPresentShader->SetFloat2("uRenderScale", Vector2(float(mRenderWidth) / mWidth, float(mRenderHeight) / mHeight));
+		mPresentShader->SetFloat("uExposure", mExposure);
+		mPresentShader->SetFloat("uVignette", mVignette);
 		glBindVertexArray(mPresentVAO);
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, mColorAttachment);
@@ -456,42 +716,63 @@ void Engine::MainPass()
 
 		mTextRenderer->RenderText("Player1: " + std::to_string(mPlayer1.mScore), 25.0f, mHeight - 25.0f, 0.4f, Vector3(1, 0, 0));
 		mTextRenderer->RenderText("Player2: " + std::to_string(mPlayer2.mScore), mWidth - 120.0f, mHeight - 25.0f, 0.4f, Vector3(1, 0, 0));
+		mTextRenderer->RenderText(std::format("PCF ({} taps, F7): {:.3f} ms scene", mShadowTaps, mSceneTimer.GetMilliseconds()), 25.0f, 65.0f, 0.3f, Vector3(1, 1, 1));
+		mTextRenderer->RenderText(std::format("Shadow ({}, F6): {:.3f} ms, {}. Full redraw: geometry shader {:.3f} ms, layered {:.3f} ms, per face {:.3f} ms",
+			ShadowModeName(mShadowMode), mShadowTimer.GetMilliseconds(), mShadowUpdate, mShadowModeTimers[0].GetMilliseconds(), mShadowModeTimers[1].GetMilliseconds(), mShadowModeTimers[2].GetMilliseconds()), 25.0f, 45.0f, 0.3f, Vector3(1, 1, 1));
+		RenderStats total = mShadowStats;
+		total += mMainStats;
+		mTextRenderer->RenderText(std::format("Resolution (F9): {}x{} ({:.0f}%), main pass {:.2f} ms, budget {:.1f} ms", mRenderWidth, mRenderHeight, mDynamicResolution.GetScale() * 100.0f, mMainTimer.GetMilliseconds(), mDynamicResolution.GetBudget()), 25.0f, 125.0f, 0.3f, Vector3(1, 1, 1));
+		mTextRenderer->RenderText(std::format("Picking (F8): {}", mPickOnGpu ? "ID pass" : "BVH"), 25.0f, 105.0f, 0.3f, Vector3(1, 1, 1));
+		mTextRenderer->RenderText(std::format("Culling: main {}/{} visible, shadow {}/{} visible", mMainStats.tested - mMainStats.culled, mMainStats.tested, mShadowStats.tested - mShadowStats.culled, mShadowStats.tested), 25.0f, 85.0f, 0.3f, Vector3(1, 1, 1));
+		mTextRenderer->RenderText(std::format("Draws: {}  Commands: {}  Instances: {}  State changes: {}", total.draws, total.commands, total.instances, total.StateChanges()), 25.0f, 25.0f, 0.3f, Vector3(1, 1, 1));
 	}
 }
 
 void Engine::PrepareFramebuffer()
 {
 	if (mShadowFBO) glDeleteFramebuffers(1, &mShadowFBO);
+	if (mStaticShadowFBO) glDeleteFramebuffers(1, &mStaticShadowFBO);
 	if (mMainFBO) glDeleteFramebuffers(1, &mMainFBO);
 	if (mColorAttachment) glDeleteTextures(1, &mColorAttachment);
-	if (mIDAttachment) glDeleteTextures(1, &mIDAttachment);
 	if (mDepthAttachment) glDeleteTextures(1, &mDepthAttachment);
+	if (mPickFBO) glDeleteFramebuffers(1, &mPickFBO);
+	if (mIDAttachment) glDeleteTextures(1, &mIDAttachment);
+	if (mPickDepth) glDeleteTextures(1, &mPickDepth);
 	if (mShadowMap) glDeleteTextures(1, &mShadowMap);
-
-	/// Shadow Pass 
-	glGenFramebuffers(1, &mShadowFBO);
-
-	glGenTextures(1, &mShadowMap);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, mShadowMap);
-	for (GLuint i = 0; i < 6; ++i)
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT,
-			mShadowMapWidth, mShadowMapHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-
-	glBindFramebuffer(GL_FRAMEBUFFER, mShadowFBO);
-	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mShadowMap, 0);
-	glDrawBuffer(GL_NONE);
-	glReadBuffer(GL_NONE);
-
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-	{
-		INFO("Error Shadow Pass");
-	}
+	if (mStaticShadowMap) glDeleteTextures(1, &mStaticShadowMap);
+
+	/// Shadow Pass, the composed cube sampled by the main pass and the cache of the static casters
+	auto createShadowCube = [&](GLuint& fbo, GLuint& cubeMap) {
+		glGenFramebuffers(1, &fbo);
+
+		glGenTextures(1, &cubeMap);
+		glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap);
+		for (GLuint i = 0; i < 6; ++i)
+			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT24,
+				mShadowMapWidth, mShadowMapHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		// sampled through samplerCubeShadow, linear filtering makes each lookup a 2x2 PCF
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cubeMap, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			INFO("Error Shadow Pass");
+		}
+	};
+	createShadowCube(mShadowFBO, mShadowMap);
+	createShadowCube(mStaticShadowFBO, mStaticShadowMap);
+	InvalidateStaticShadows();
+	mShadowCarMatrices.clear();
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -501,19 +782,12 @@ void Engine::PrepareFramebuffer()
 
 	glGenTextures(1, &mColorAttachment);
 	glBindTexture(GL_TEXTURE_2D, mColorAttachment);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, mWidth, mHeight, 0, GL_RGB, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glGenTextures(1, &mIDAttachment);
-	glBindTexture(GL_TEXTURE_2D, mIDAttachment);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32I, mWidth, mHeight, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// linear HDR, the present pass tonemaps
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, mWidth, mHeight, 0, GL_RGBA, GL_HALF_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	glGenTextures(1, &mDepthAttachment);
 	glBindTexture(GL_TEXTURE_2D, mDepthAttachment);
@@ -521,24 +795,50 @@ void Engine::PrepareFramebuffer()
 
 	glBindFramebuffer(GL_FRAMEBUFFER, mMainFBO);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColorAttachment, 0);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mIDAttachment, 0);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, mDepthAttachment, 0);
-	GLenum buffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
-	glDrawBuffers(2, buffers);
 	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
 	{
 		INFO("Error Main Pass");
 	}
+
+	/// Pick Pass, window sized but only a few pixels around the cursor are ever drawn
+	glGenFramebuffers(1, &mPickFBO);
+
+	glGenTextures(1, &mIDAttachment);
+	glBindTexture(GL_TEXTURE_2D, mIDAttachment);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32I, mWidth, mHeight, 0, GL_RED_INTEGER, GL_INT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glGenTextures(1, &mPickDepth);
+	glBindTexture(GL_TEXTURE_2D, mPickDepth);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, mWidth, mHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, mPickFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mIDAttachment, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mPickDepth, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		INFO("Error Pick Pass");
+	}
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	mPickRequests.clear();
+	mSteerPending = false;
 }
 
 void Engine::PrepareShader()
 {
-	mShadowShader = make_shared<class Shader>("asset/shader/shadow.vs", "asset/shader/shadow.fs", "asset/shader/shadow.gs");
-	mMainShader = make_shared<class Shader>("asset/shader/pbr.vs", "asset/shader/pbr.fs");
-	mPresentShader = make_shared<class Shader>("asset/shader/present.vs", "asset/shader/present.fs");
-	mSkyboxShader = make_shared<class Shader>("asset/shader/skybox.vs", "asset/shader/skybox.fs");
-	mLUT = make_shared<class Texture2D>("asset/texture/BRDF_LUT.tga");
+	mShadowShader = ResourceManager::Get().GetShader("asset/shader/shadow.vs", "asset/shader/shadow.fs", "asset/shader/shadow.gs");
+	mLayeredShadowShader = ResourceManager::Get().GetShader("asset/shader/shadow_layered.vs", "asset/shader/shadow.fs");
+	mMainShader = ResourceManager::Get().GetShader("asset/shader/pbr.vs", "asset/shader/pbr.fs");
+	mPickShader = ResourceManager::Get().GetShader("asset/shader/pick.vs", "asset/shader/pick.fs");
+	mPresentShader = ResourceManager::Get().GetShader("asset/shader/present.vs", "asset/shader/present.fs");
+	mSkyboxShader = ResourceManager::Get().GetShader("asset/shader/skybox.vs", "asset/shader/skybox.fs");
+	mFrameUBO = make_shared<class UniformBuffer>(FrameBinding, sizeof(FrameData));
+	mViewUBO = make_shared<class UniformBuffer>(ViewBinding, sizeof(ViewData));
+	mLightUBO = make_shared<class UniformBuffer>(LightBinding, sizeof(LightData));
+	mShadowUBO = make_shared<class UniformBuffer>(ShadowBinding, sizeof(ShadowData));
+	mLUT = ResourceManager::Get().GetTexture2D("asset/texture/BRDF_LUT.tga");
 	float quadVertices[] = {
 		-1.0f,  1.0f,  0.0f, 1.0f,
 		-1.0f, -1.0f,  0.0f, 0.0f,
@@ -563,11 +863,10 @@ void Engine::PrepareShader()
 void Engine::PrepareScene()
 {
 	mCamera = make_shared<class Camera>(45.0f, float(mWidth) / float(mHeight), 0.1f, 100.0f);
-	mCube = make_shared<class Model>("asset/model/cube.obj");
+	mCube = ResourceManager::Get().GetModel("asset/model/cube.obj");
 
-	mDefaultTexture = make_shared<class Texture2D>("asset/texture/default.png");
-	mPlayer1Texture = make_shared<class Texture2D>("asset/texture/player1.png");
-	mPlayer2Texture = make_shared<class Texture2D>("asset/texture/player2.png");
+	// in Car::Skin order
+	mCarSkins = ResourceManager::Get().GetTexture2DArray(vector<string>{ "asset/texture/default.png", "asset/texture/player1.png", "asset/texture/player2.png" });
 
 	mEnvironment.Init(mWidth, mHeight);
 	mEnvironment.Draw();
@@ -578,51 +877,51 @@ void Engine::PrepareScene()
 	mCars.push_back(make_shared<class Car>(Vector3(-1, 0, -1)));
 	mCars.push_back(make_shared<class Car>(Vector3(-1, 0, 1)));
 
-	for (auto& car : mCars)
-		car->mTexture = mDefaultTexture;
-
 	// materials from https://www.texturecan.com/details/569/
 	//õ
 	{
-		auto albedo = make_shared<class Texture2D>("asset/texture/ground_color.jpg");
-		auto normal = make_shared<class Texture2D>("asset/texture/ground_normal.png");
-		auto roughness = make_shared<class Texture2D>("asset/texture/ground_roughness.jpg");
+		auto albedo = ResourceManager::Get().GetTexture2D("asset/texture/ground_color.jpg");
+		auto normal = ResourceManager::Get().GetTexture2D("asset/texture/ground_normal.png");
+		auto roughness = ResourceManager::Get().GetTexture2D("asset/texture/ground_roughness.jpg");
 
 		auto& wall = mWalls.emplace_back(make_shared<class Wall>("asset/model/cube.obj"));
-		wall->mTransform.mPosition = Vector3(0, -0.15, 0);
-		wall->mTransform.mScale = Vector3(20, 0.01, 20);
+		TransformStore::Get().Position(wall->mTransform) = Vector3(0, -0.15, 0);
+		TransformStore::Get().Scale(wall->mTransform) = Vector3(20, 0.01, 20);
 		wall->mUVScale = Vector2(20, 20) * 10;
 		wall->mAlbedoTexture = albedo;
 		wall->mNormalTexture = normal;
 		wall->mRoughnessTexture = roughness;
-		for (auto& mesh : wall->mModel->GetMesh()) {
-			mesh->mMaterial.Albedo = Vector3(0.8);
-			mesh->mMaterial.Roughness = 0.2f;
-			mesh->mMaterial.Metallic = 0.1f;
-		}
+		wall->mMaterial.Albedo = Vector3(0.8);
+		wall->mMaterial.Roughness = 0.2f;
+		wall->mMaterial.Metallic = 0.1f;
 	}
 	
 	//ǽ
 	{
-		auto albedo = make_shared<class Texture2D>("asset/texture/wall_color.jpg");
-		auto normal = make_shared<class Texture2D>("asset/texture/wall_normal.png");
-		auto roughness = make_shared<class Texture2D>("asset/texture/wall_roughness.jpg");
+		auto albedo = ResourceManager::Get().GetTexture2D("asset/texture/wall_color.jpg");
+		auto normal = ResourceManager::Get().GetTexture2D("asset/texture/wall_normal.png");
+		auto roughness = ResourceManager::Get().GetTexture2D("asset/texture/wall_roughness.jpg");
 
 		auto& wall = mWalls.emplace_back(make_shared<class Wall>("asset/model/cube.obj"));
-		wall->mTransform.mPosition = Vector3(10, -0.15, 0);
-		wall->mTransform.mScale = Vector3(0.1, 1, 20);
+		TransformStore::Get().Position(wall->mTransform) = Vector3(10, -0.15, 0);
+		TransformStore::Get().Scale(wall->mTransform) = Vector3(0.1, 1, 20);
 		wall->mUVScale = Vector2(1, 20) * 3;
 		wall->mAlbedoTexture = albedo;
 		wall->mNormalTexture = normal;
 		wall->mRoughnessTexture = roughness;
-		for (auto& mesh : wall->mModel->GetMesh()) {
-			mesh->mMaterial.Albedo = Vector3(0.8);
-			mesh->mMaterial.Roughness = 0.2f;
-			mesh->mMaterial.Metallic = 0.0f;
-		}
+		wall->mMaterial.Albedo = Vector3(0.8);
+		wall->mMaterial.Roughness = 0.2f;
+		wall->mMaterial.Metallic = 0.0f;
 	}
 
+	InvalidateStaticShadows();
+}
 
+void Engine::SetLightPosition(const Vector3& pos)
+{
+	if (pos == mLightPos) return;
+	mLightPos = pos;
+	InvalidateStaticShadows();
 }
 
 std::pair<float, float> Engine::GetMousePosition()
@@ -647,24 +946,36 @@ void Engine::SetMouseInvisible()
 	glfwSetInputMode(mWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 }
 
-int Engine::ReadPixel()
+Engine::PickResult Engine::Pick(float x, float y)
 {
-	auto pos = GetMousePosition();
-	glBindFramebuffer(GL_FRAMEBUFFER, mMainFBO);
-	glReadBuffer(GL_COLOR_ATTACHMENT1);
-	int pixelData;
-	glReadPixels(pos.first, mHeight - pos.second, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	return pixelData;
+	const Vector4 viewport(0, 0, mWidth, mHeight);
+	const Matrix4& inverseViewProjection = mCamera->GetInverseViewProjection();
+	const Vector3 nearPoint = Math::Unproject(Vector3(x, mHeight - y, 0.0f), inverseViewProjection, viewport);
+	const Vector3 farPoint = Math::Unproject(Vector3(x, mHeight - y, 1.0f), inverseViewProjection, viewport);
+	const Ray ray(nearPoint, Math::Normalize(farPoint - nearPoint));
+
+	UpdatePickBvh();
+	PickResult result;
+	float t = 0.0f;
+	const int index = mPickBvh.Raycast(ray, t);
+	if (index < 0) return result;
+	result.hit = true;
+	result.entityID = mPickEntities[index];
+	result.position = ray.At(t);
+	return result;
 }
 
-float Engine::ReadDepth()
+void Engine::RequestPick(float x, float y, std::function<void(int)> callback)
 {
-	auto pos = GetMousePosition();
-	glBindFramebuffer(GL_FRAMEBUFFER, mMainFBO);
-	glReadBuffer(GL_DEPTH_ATTACHMENT);
-	float pixelData;
-	glReadPixels(pos.first, mHeight - pos.second, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &pixelData);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	return pixelData;
+	const int pixelX = int(x), pixelY = int(mHeight - y);
+	if (pixelX < 0 || pixelY < 0 || pixelX >= int(mWidth) || pixelY >= int(mHeight)) return;
+	mPickRequests.push_back({ pixelX, pixelY, std::move(callback), nullptr });
+}
+
+bool Engine::RequestPickPosition(float x, float y, std::function<void(bool hit, Vector3 position)> callback)
+{
+	const int pixelX = int(x), pixelY = int(mHeight - y);
+	if (pixelX < 0 || pixelY < 0 || pixelX >= int(mWidth) || pixelY >= int(mHeight)) return false;
+	mPickRequests.push_back({ pixelX, pixelY, nullptr, std::move(callback) });
+	return true;
 }
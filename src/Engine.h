@@ -2,12 +2,24 @@
 
 #include "Car.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "GpuTimer.h"
+#include "Readback.h"
+#include "DynamicResolution.h"
+#include "math/Bvh.h"
 #include "Camera.h"
 #include "Environment.h"
 #include "TextRenderer.h"
 
 class Engine {
 public:
+	// How the six faces of the shadow cube are filled, F6 cycles through the supported ones
+	enum class ShadowMode {
+		GeometryShader, // shadow.gs emits every triangle into all six faces
+		Layered,        // casters culled per face on the CPU, instanced per face, gl_Layer from the vertex shader
+		PerFace,        // same culling, one face attached and drawn at a time (no vertex shader gl_Layer)
+	};
+
 	Engine();
 
 	~Engine();
@@ -25,10 +37,16 @@ public:
 	void OnMouseScroll(float offset);
 	void OnMousePress(int button);
 	void OnMouseRelease(int button);
+	void OnKeyPress(int key);
 	void OnEvent();
 
 	void UpdateScene(GLfloat delta);
+	void UpdateTransforms();
+	void UpdateUniformBuffers(GLfloat time, GLfloat delta);
+	void PickPass();
 	void ShadowPass();
+	void DrawShadowCasters(GLuint cubeMap, bool dynamic);
+	void SubmitShadowCasters(const ShaderPtr& shader, bool dynamic);
 	void MainPass();
 
 	void PrepareFramebuffer();
@@ -40,8 +58,27 @@ public:
 	void SetMouseVisible();
 	void SetMouseInvisible();
 	Vector2 GetViewportSize() { return Vector2(mWidth, mHeight); }
-	int ReadPixel();
-	float ReadDepth();
+	// main pass viewport, the window size times the dynamic resolution scale
+	void UpdateRenderSize();
+	// CPU picking: the ray through window pixel (x, y) against the bounds of every car and wall mesh
+	struct PickResult {
+		bool hit = false;
+		int entityID = -1; // cars only, walls and misses are -1
+		Vector3 position;  // world space point where the ray enters the hit box, see RequestPickPosition for the surface
+	};
+	PickResult Pick(float x, float y);
+	void UpdatePickBvh();
+	// Exact picking: renders entity IDs around (x, y) in PickPass and calls back with the ID under
+	// the pixel once mReadback has it, a frame or two later
+	void RequestPick(float x, float y, std::function<void(int)> callback);
+	// Same pass, but reads the depth under the pixel back and calls back with the exact world space
+	// point (hit false over the sky). Returns false when (x, y) is outside the window.
+	bool RequestPickPosition(float x, float y, std::function<void(bool hit, Vector3 position)> callback);
+	void SelectCar(int id);
+	// moves the light and drops the static shadow cache if it actually moved
+	void SetLightPosition(const Vector3& pos);
+	// redraw the walls into mStaticShadowMap next ShadowPass, for anything that changes static casters
+	void InvalidateStaticShadows() { mStaticShadowDirty = true; }
 	/// Scene
 private:
 	vector<CarPtr> mCars;
@@ -53,23 +90,63 @@ private:
 	Player mPlayer1, mPlayer2;
 	bool mPlay = false;
 	Environment mEnvironment;
-	Texture2DPtr mDefaultTexture, mPlayer1Texture, mPlayer2Texture;
+	Texture2DArrayPtr mCarSkins;
 
 	unordered_map<string, bool> mIsPressed;
+
+	// world bounds of every car and wall mesh with the owner's entity ID, refit by the first Pick
+	// after the transforms changed
+	vector<AABB> mPickBounds;
+	vector<int> mPickEntities;
+	Bvh mPickBvh;
+	bool mPickBvhDirty = true;
+	bool mPickOnGpu = true; // selection and steering through the ID pass or the BVH, F8 toggles
+	struct PickRequest {
+		int x, y; // framebuffer pixel
+		std::function<void(int)> callback;                   // entity ID, may be empty
+		std::function<void(bool, Vector3)> positionCallback; // depth under the pixel, may be empty
+	};
+	vector<PickRequest> mPickRequests;
+	bool mSteerPending = false; // one steering pick in flight at a time
 	/// Window
 private:
 	size_t mWidth = 800;
 	size_t mHeight = 600;
+	size_t mRenderWidth = 800, mRenderHeight = 600;
 	GLFWwindow* mWindow;
 	static Engine* sInstance;
 
 	/// Render 
 	TextRendererPtr mTextRenderer;
+	PixelReadback mReadback;
 private:
 	const GLuint mShadowMapWidth = 1024, mShadowMapHeight = 1024;
-	GLuint mMainFBO = 0, mShadowFBO = 0;
-	GLuint mShadowMap = 0, mColorAttachment = 0, mIDAttachment = 0, mDepthAttachment = 0;
-	ShaderPtr mShadowShader, mMainShader, mPresentShader, mSkyboxShader;
+	const GLfloat mShadowFarPlane = 25.0f;
+	ShadowMode mShadowMode = ShadowMode::PerFace;
+	bool mVertexShaderLayer = false; // ARB_shader_viewport_layer_array or AMD_vertex_shader_layer
+	Frustum mShadowFrusta[6];
+	GpuTimer mShadowTimer; // whatever the shadow pass did this frame, the fixed part of the resolution budget
+	// Per ShadowMode, only frames that redraw every caster (walls + cars), so the geometry shader,
+	// layered and per-face paths are compared on the same work
+	GpuTimer mShadowModeTimers[3];
+	int mShadowTaps = 8;  // PCF taps per fragment, F7 cycles 1/4/8/16
+	GpuTimer mSceneTimer; // main pass scene draws, where the PCF cost shows up
+	GpuTimer mMainTimer;  // everything drawn into mMainFBO, drives mDynamicResolution
+	DynamicResolution mDynamicResolution; // F9 toggles
+	// present.fs, applied once per pixel to the linear HDR scene
+	float mExposure = 1.0f;
+	float mVignette = 0.0f;
+	// Walls never move, their depth is kept in mStaticShadowMap and copied into mShadowMap before the
+	// cars are drawn on top. The cache is redrawn only after InvalidateStaticShadows.
+	bool mStaticShadowDirty = true;
+	vector<Matrix4> mShadowCarMatrices; // car transforms in mShadowMap, nothing to do while they and the light hold still
+	const char* mShadowUpdate = "";     // what the last ShadowPass redrew, for the HUD
+	GLuint mMainFBO = 0, mShadowFBO = 0, mStaticShadowFBO = 0, mPickFBO = 0;
+	GLuint mShadowMap = 0, mStaticShadowMap = 0, mColorAttachment = 0, mDepthAttachment = 0, mIDAttachment = 0, mPickDepth = 0;
+	ShaderPtr mShadowShader, mLayeredShadowShader, mMainShader, mPickShader, mPresentShader, mSkyboxShader;
+	UniformBufferPtr mFrameUBO, mViewUBO, mLightUBO, mShadowUBO;
+	RenderQueue mShadowQueue{ false }, mMainQueue, mPickQueue{ false };
+	RenderStats mShadowStats, mMainStats; // shown on the HUD
 	GLuint mPresentVAO, mPresentVBO;
 	ModelPtr mCube;
 	Texture2DPtr mLUT;
@@ -7,19 +7,19 @@ Environment::Environment()
 
 void Environment::Init(int width, int height)
 {
-	mCube = make_shared<class Model>("asset/model/cube.obj");
+	mCube = ResourceManager::Get().GetModel("asset/model/cube.obj");
 
 
-	mEquirectangularToCubeMapShader = make_shared<class Shader>(mEquirectangularToCubeMapShaderPath + ".vs", mEquirectangularToCubeMapShaderPath + ".fs");
-	mPrefilterShader = make_shared<class Shader>(mPrefilterShaderPath + ".vs", mPrefilterShaderPath + ".fs");
-	mConvolutionShader = make_shared<class Shader>(mConvolutionShaderPath + ".vs", mConvolutionShaderPath + ".fs");
+	mEquirectangularToCubeMapShader = ResourceManager::Get().GetShader(mEquirectangularToCubeMapShaderPath + ".vs", mEquirectangularToCubeMapShaderPath + ".fs");
+	mPrefilterShader = ResourceManager::Get().GetShader(mPrefilterShaderPath + ".vs", mPrefilterShaderPath + ".fs");
+	mConvolutionShader = ResourceManager::Get().GetShader(mConvolutionShaderPath + ".vs", mConvolutionShaderPath + ".fs");
 
-	mEnvironmentCubeMap = make_shared<TextureCube>(32, 32);
+	mEnvironmentCubeMap = ResourceManager::Get().GetTextureCube("environment/irradiance", 32, 32);
 
-	mReflectionCubeMap = make_shared<TextureCube>(512, 512);
+	mReflectionCubeMap = ResourceManager::Get().GetTextureCube("environment/prefilter", 512, 512);
 	mReflectionCubeMap->GenerateMipmaps();
 
-	mTextureCube = make_shared<TextureCube>(512, 512);
+	mTextureCube = ResourceManager::Get().GetTextureCube("environment/sky", 512, 512);
 
 	Resize(width, height);
 }
@@ -27,7 +27,7 @@ void Environment::Init(int width, int height)
 
 void Environment::Draw()
 {
-	mTexture = make_shared<Texture2D>(mPath);
+	mTexture = ResourceManager::Get().GetTexture2D(mPath);
 
 	Matrix4 captureProjection = Math::Perspective(Math::Radians(90.0f), 1.0f, 0.1f, 10.0f);
 	Matrix4 captureViews[] = { Math::LookAt(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, -1.0f, 0.0f)),
@@ -51,11 +51,8 @@ void Environment::Draw()
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mTextureCube->GetID(), 0);
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		for (auto mesh : mCube->GetMesh()) {
-			glBindVertexArray(mesh->VAO);
-			glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-			glBindVertexArray(0);
-		}
+		for (auto& mesh : mCube->GetMesh())
+			mesh->Draw();
 	}
 
 	// Convolution
@@ -71,11 +68,8 @@ void Environment::Draw()
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mEnvironmentCubeMap->GetID(), 0);
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		for (auto mesh : mCube->GetMesh()) {
-			glBindVertexArray(mesh->VAO);
-			glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-			glBindVertexArray(0);
-		}
+		for (auto& mesh : mCube->GetMesh())
+			mesh->Draw();
 	}
 
 	mEquirectangularToCubeMapShader->Use();
@@ -108,11 +102,8 @@ void Environment::Draw()
 			mPrefilterShader->SetMat4("u_View", captureViews[i]);
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mReflectionCubeMap->GetID(), mip);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			for (auto mesh : mCube->GetMesh()) {
-				glBindVertexArray(mesh->VAO);
-				glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mesh->mIndices.size()), GL_UNSIGNED_INT, 0);
-				glBindVertexArray(0);
-			}
+			for (auto& mesh : mCube->GetMesh())
+				mesh->Draw();
 		}
 	}
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
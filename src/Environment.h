@@ -2,6 +2,7 @@
 #include "Model.h"
 #include "math/Matrix.h"
 #include "Shader.h"
+#include "ResourceManager.h"
 class Environment {
 public:
 	Environment();
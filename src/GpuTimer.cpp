@@ -0,0 +1,32 @@
+#include "GpuTimer.h"
+
+void GpuTimer::Begin()
+{
+	if (!mQueries[0][0]) glGenQueries(sFramesInFlight * 2, &mQueries[0][0]);
+
+	// frames back, the result is normally available and this does not wait
+	if (mPending[mCurrent])
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(mQueries[mCurrent][0], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(mQueries[mCurrent][1], GL_QUERY_RESULT, &end);
+		const float ms = float(end - begin) * 1e-6f;
+		mAverage = mSamples++ == 0 ? ms : mAverage + (ms - mAverage) * 0.05f;
+	}
+	glQueryCounter(mQueries[mCurrent][0], GL_TIMESTAMP);
+}
+
+void GpuTimer::End()
+{
+	glQueryCounter(mQueries[mCurrent][1], GL_TIMESTAMP);
+	mPending[mCurrent] = true;
+	mCurrent = (mCurrent + 1) % sFramesInFlight;
+}
+
+void GpuTimer::Reset()
+{
+	for (bool& pending : mPending)
+		pending = false;
+	mSamples = 0;
+	mAverage = 0.0f;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "Defines.h"
+#include "glad/glad.h"
+
+// GPU time of a block of commands through a pair of GL_TIMESTAMP queries. Unlike GL_TIME_ELAPSED,
+// timestamps are not active queries, so timers can nest (the scene inside the main pass). Queries
+// of the last few frames stay in flight and are read once their frame comes around again, so
+// timing never stalls the pipeline. The result is an exponential moving average in milliseconds.
+class GpuTimer {
+public:
+	void Begin();
+	void End();
+
+	float GetMilliseconds() const { return mAverage; }
+	// forget the average and the queries in flight, e.g. after switching what is measured
+	void Reset();
+private:
+	static constexpr int sFramesInFlight = 4;
+	GLuint mQueries[sFramesInFlight][2] = {}; // begin and end timestamp
+	bool mPending[sFramesInFlight] = {};
+	int mCurrent = 0;
+	int mSamples = 0;
+	float mAverage = 0.0f;
+};
@@ -1,34 +1,157 @@
 #include "Model.h"
+#include <algorithm>
+uint64_t Mesh::sNextID = 0;
 
-void Mesh::InitMesh()
+bool RangeAllocator::Allocate(uint32_t size, uint32_t& offset)
 {
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &EBO);
+	for (size_t i = 0; i < mFree.size(); ++i)
+	{
+		Block& block = mFree[i];
+		if (block.size < size) continue;
+		offset = block.offset;
+		block.offset += size;
+		block.size -= size;
+		if (block.size == 0) mFree.erase(mFree.begin() + i);
+		return true;
+	}
+	return false;
+}
 
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(Vertex), &mVertices[0], GL_STATIC_DRAW);
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+	if (size == 0) return;
+	auto next = std::lower_bound(mFree.begin(), mFree.end(), offset, [](const Block& b, uint32_t o) { return b.offset < o; });
+	next = mFree.insert(next, { offset, size });
+	// merge with the following, then with the preceding block
+	if (next + 1 != mFree.end() && next->offset + next->size == (next + 1)->offset)
+	{
+		next->size += (next + 1)->size;
+		mFree.erase(next + 1);
+	}
+	if (next != mFree.begin() && (next - 1)->offset + (next - 1)->size == next->offset)
+	{
+		(next - 1)->size += next->size;
+		mFree.erase(next);
+	}
+}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(unsigned int), &mIndices[0], GL_STATIC_DRAW);
+void RangeAllocator::Grow(uint32_t capacity)
+{
+	assert(capacity >= mCapacity);
+	const uint32_t old = mCapacity;
+	mCapacity = capacity;
+	Free(old, capacity - old);
+}
 
+GeometryArena& GeometryArena::Get()
+{
+	static GeometryArena sInstance;
+	return sInstance;
+}
 
+void GeometryArena::Init()
+{
+	glGenVertexArrays(1, &mVAO);
+	glBindVertexArray(mVAO);
+	GrowBuffer(mVBO, GL_ARRAY_BUFFER, 0, size_t(1 << 16) * sizeof(PackedVertex));
+	GrowBuffer(mEBO, GL_ELEMENT_ARRAY_BUFFER, 0, size_t(1 << 18) * sizeof(unsigned int));
+	mVertices.Grow(1 << 16);
+	mIndices.Grow(1 << 18);
+	SetupAttributes();
+	glBindVertexArray(0);
+}
+
+// points the attributes of the bound VAO at mVBO, again after every grow
+void GeometryArena::SetupAttributes()
+{
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Position));
 
 	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+	glVertexAttribPointer(1, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Normal));
 
 	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, TexCoords));
 
 	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+	glVertexAttribPointer(3, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Tangent));
 
 	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+	glVertexAttribPointer(4, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Bitangent));
+}
+
+// New storage of newSize bytes with the old contents copied over on the GPU. The VAO has to be
+// bound: the element buffer binding is VAO state and the vertex attributes need re-pointing.
+void GeometryArena::GrowBuffer(unsigned int& buffer, GLenum target, size_t oldSize, size_t newSize)
+{
+	unsigned int grown;
+	glGenBuffers(1, &grown);
+	glBindBuffer(target, grown);
+	glBufferData(target, newSize, nullptr, GL_STATIC_DRAW);
+	if (buffer)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, 0, oldSize);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glDeleteBuffers(1, &buffer);
+	}
+	buffer = grown;
+}
+
+GeometryRange GeometryArena::Allocate(std::span<const PackedVertex> vertices, std::span<const unsigned int> indices)
+{
+	if (!mVAO) Init();
+
+	GeometryRange range;
+	range.vertexCount = static_cast<uint32_t>(vertices.size());
+	range.indexCount = static_cast<uint32_t>(indices.size());
+	if (mFreeIDs.empty()) range.id = mNextID++;
+	else
+	{
+		range.id = mFreeIDs.back();
+		mFreeIDs.pop_back();
+	}
+
+	glBindVertexArray(mVAO);
+	while (!mVertices.Allocate(range.vertexCount, range.baseVertex))
+	{
+		const uint32_t capacity = mVertices.GetCapacity();
+		GrowBuffer(mVBO, GL_ARRAY_BUFFER, size_t(capacity) * sizeof(PackedVertex), size_t(capacity) * 2 * sizeof(PackedVertex));
+		mVertices.Grow(capacity * 2);
+		SetupAttributes();
+	}
+	while (!mIndices.Allocate(range.indexCount, range.firstIndex))
+	{
+		const uint32_t capacity = mIndices.GetCapacity();
+		GrowBuffer(mEBO, GL_ELEMENT_ARRAY_BUFFER, size_t(capacity) * sizeof(unsigned int), size_t(capacity) * 2 * sizeof(unsigned int));
+		mIndices.Grow(capacity * 2);
+	}
 
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+	glBufferSubData(GL_ARRAY_BUFFER, size_t(range.baseVertex) * sizeof(PackedVertex), vertices.size_bytes(), vertices.data());
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, size_t(range.firstIndex) * sizeof(unsigned int), indices.size_bytes(), indices.data());
+	glBindVertexArray(0);
+	return range;
+}
+
+void GeometryArena::Free(const GeometryRange& range)
+{
+	mVertices.Free(range.baseVertex, range.vertexCount);
+	mIndices.Free(range.firstIndex, range.indexCount);
+	mFreeIDs.push_back(range.id);
+}
+
+void Mesh::InitMesh()
+{
+	vector<PackedVertex> packed(mVertices.begin(), mVertices.end());
+	mGeometry = GeometryArena::Get().Allocate(packed, mIndices);
+}
+
+void Mesh::Draw()
+{
+	GeometryArena::Get().Bind();
+	glDrawElementsBaseVertex(GL_TRIANGLES, mGeometry.indexCount, GL_UNSIGNED_INT, (void*)(size_t(mGeometry.firstIndex) * sizeof(unsigned int)), mGeometry.baseVertex);
 	glBindVertexArray(0);
 }
 
@@ -169,3 +292,53 @@ void Texture2D::Bind(int slot)
 	glActiveTexture(GL_TEXTURE0 + slot);
 	glBindTexture(GL_TEXTURE_2D, mID);
 }
+
+Texture2DArray::Texture2DArray(const vector<string>& paths)
+{
+	// global stb state, flipped like every other texture (Utils::LoadTexture sets it as well)
+	stbi_set_flip_vertically_on_load(true);
+	glGenTextures(1, &mID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, mID);
+
+	// storage is sized from the first layer that loads, layers that fail are logged and skipped
+	int layerWidth = 0, layerHeight = 0;
+	for (size_t layer = 0; layer < paths.size(); ++layer)
+	{
+		int width, height, nrComponents;
+		unsigned char* data = stbi_load(paths[layer].c_str(), &width, &height, &nrComponents, 4);
+		if (!data)
+		{
+			std::cout << stbi_failure_reason() << std::endl;
+			std::cout << "Texture failed to load at path: " << paths[layer] << std::endl;
+			continue;
+		}
+		if (layerWidth == 0)
+		{
+			layerWidth = width;
+			layerHeight = height;
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, (GLsizei)paths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+		if (width == layerWidth && height == layerHeight)
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		else
+			std::cout << "Texture array layer " << paths[layer] << " is " << width << "x" << height << ", expected " << layerWidth << "x" << layerHeight << std::endl;
+		stbi_image_free(data);
+	}
+	if (layerWidth == 0)
+	{
+		std::cout << "Texture array has no loadable layer, " << paths.size() << " paths failed" << std::endl;
+		return;
+	}
+
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+void Texture2DArray::Bind(int slot)
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, mID);
+}
@@ -2,11 +2,15 @@
 #include "Defines.h"
 #include "Utils.h"
 #include "math/Matrix.h"
+#include "math/Geometry.h"
+#include "math/Random.h"
+#include "math/Packed.h"
 #include "Shader.h"
 using MeshPtr = shared_ptr<class Mesh>;
 using ModelPtr = shared_ptr<class Model>;
 using Texture2DPtr = shared_ptr<class Texture2D>;
 using TextureCubePtr = shared_ptr<class TextureCube>;
+using Texture2DArrayPtr = shared_ptr<class Texture2DArray>;
 
 struct Vertex {
 	Vector3 Position;
@@ -16,9 +20,71 @@ struct Vertex {
 	Vector3 Bitangent;
 };
 
+// What InitMesh uploads: 40 instead of 56 bytes. The GL attributes are normalized shorts and half
+// floats, so the shaders still read vec3/vec2.
+struct PackedVertex {
+	Vector3 Position;
+	Half2 TexCoords;
+	SNorm16x4 Normal;
+	SNorm16x4 Tangent;
+	SNorm16x4 Bitangent;
+
+	PackedVertex() = default;
+	explicit PackedVertex(const Vertex& v)
+		: Position(v.Position), TexCoords(v.TexCoords), Normal(v.Normal), Tangent(v.Tangent), Bitangent(v.Bitangent) {}
+};
+static_assert(sizeof(PackedVertex) == 40);
+
+// Where a mesh lives in the GeometryArena, in vertices and indices
+struct GeometryRange {
+	uint32_t baseVertex = 0, vertexCount = 0;
+	uint32_t firstIndex = 0, indexCount = 0;
+	uint32_t id = 0; // dense among the live ranges, reused after Free, RenderQueue sorts by it
+};
+
+// First-fit sub-allocator over [0, capacity) that merges neighbouring free blocks
+class RangeAllocator {
+public:
+	// returns false when no free block is large enough, Grow and try again
+	bool Allocate(uint32_t size, uint32_t& offset);
+	void Free(uint32_t offset, uint32_t size);
+	void Grow(uint32_t capacity);
+	uint32_t GetCapacity() const { return mCapacity; }
+private:
+	struct Block {
+		uint32_t offset, size;
+	};
+	vector<Block> mFree; // sorted by offset
+	uint32_t mCapacity = 0;
+};
+
+// All mesh geometry in one vertex buffer and one index buffer behind one VAO, so a whole pass can
+// be drawn with glMultiDrawElementsIndirect. Indices stay relative to the mesh, the draws add
+// baseVertex. The buffers double (with a GPU copy) when they run out.
+class GeometryArena {
+public:
+	static GeometryArena& Get();
+
+	GeometryRange Allocate(std::span<const PackedVertex> vertices, std::span<const unsigned int> indices);
+	void Free(const GeometryRange& range);
+
+	void Bind() { glBindVertexArray(mVAO); }
+	unsigned int GetVAO() const { return mVAO; }
+private:
+	GeometryArena() = default;
+	void Init();
+	void SetupAttributes();
+	static void GrowBuffer(unsigned int& buffer, GLenum target, size_t oldSize, size_t newSize);
+
+	unsigned int mVAO = 0, mVBO = 0, mEBO = 0;
+	RangeAllocator mVertices, mIndices;
+	vector<uint32_t> mFreeIDs;
+	uint32_t mNextID = 0;
+};
+
 class Texture2D {
 public:
-	Texture2D(const string& path) { mID = Utils::LoadTexture(path); }
+	Texture2D(const string& path, bool gamma = false) { mID = Utils::LoadTexture(path, gamma); }
 	Texture2D(int width, int height);
 
 	void Bind(int slot);
@@ -27,6 +93,17 @@ private:
 	unsigned int mID;
 };
 
+// Same-sized RGBA8 images as the layers of one texture, so an instanced draw can pick one per instance
+class Texture2DArray {
+public:
+	Texture2DArray(const vector<string>& paths);
+
+	void Bind(int slot);
+	unsigned int GetID() { return mID; }
+private:
+	unsigned int mID;
+};
+
 class TextureCube {
 public:
 	TextureCube(int width, int height);
@@ -47,15 +124,25 @@ public:
 	{
 		this->mVertices = vertices;
 		this->mIndices = indices;
-		mMaterial.Albedo = Vector3((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX);
+		// one stream per mesh, so the colors depend on load order only
+		Philox4x32 rng(sAlbedoSeed, sNextID++);
+		float albedo[4];
+		rng.fillUniform(albedo);
+		mMaterial.Albedo = Vector3(albedo[0], albedo[1], albedo[2]);
+		for (auto& vertex : mVertices)
+			mBounds.Merge(vertex.Position);
 
 		InitMesh();
 	}
+	~Mesh() { GeometryArena::Get().Free(mGeometry); }
+	// owns its arena range, a copy would free it a second time
+	Mesh(const Mesh&) = delete;
+	Mesh& operator=(const Mesh&) = delete;
 
-	unsigned int VBO, EBO;
 	vector<Vertex> mVertices;
 	vector<unsigned int> mIndices;
-	unsigned int VAO;
+	GeometryRange mGeometry;
+	AABB mBounds; // model space
 
 	struct Material {
 		Vector3 Albedo = Vector3(1);
@@ -65,6 +152,12 @@ public:
 	}mMaterial;
 
 	void InitMesh();
+	// binds the arena VAO, for the passes that do not go through a RenderQueue
+	void Draw();
+
+private:
+	static constexpr uint64_t sAlbedoSeed = 0x4d657368;
+	static uint64_t sNextID;
 };
 
 class Model {
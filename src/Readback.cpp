@@ -0,0 +1,64 @@
+#include "Readback.h"
+
+bool PixelReadback::RequestBits(GLuint fbo, GLenum attachment, int x, int y, int width, int height, GLenum format, GLenum type, std::function<void(uint32_t)> callback)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height) return false;
+
+	// all slots in flight: only happens with several requests per frame, finish the oldest one
+	if (mPending == sSlots) Deliver(mOldest, true);
+
+	Slot& slot = mSlots[(mOldest + mPending) % sSlots];
+	if (!slot.buffer)
+	{
+		glGenBuffers(1, &slot.buffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(uint32_t), nullptr, GL_STREAM_READ);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	if (attachment != GL_DEPTH_ATTACHMENT) glReadBuffer(attachment);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	// with a pack buffer bound the pointer is an offset and the call returns immediately
+	glReadPixels(x, y, 1, 1, format, type, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.callback = std::move(callback);
+	++mPending;
+	return true;
+}
+
+void PixelReadback::Poll()
+{
+	while (mPending > 0 && Deliver(mOldest, false));
+}
+
+bool PixelReadback::Deliver(int index, bool wait)
+{
+	Slot& slot = mSlots[index];
+	if (wait)
+	{
+		glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	}
+	else
+	{
+		const GLenum status = glClientWaitSync(slot.fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+	}
+	glDeleteSync(slot.fence);
+	slot.fence = nullptr;
+
+	uint32_t bits = 0;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(bits), &bits);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	mOldest = (mOldest + 1) % sSlots;
+	--mPending;
+	// moved out first, the callback may request again and reuse this slot
+	auto callback = std::move(slot.callback);
+	slot.callback = nullptr;
+	callback(bits);
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Defines.h"
+#include "glad/glad.h"
+#include <bit>
+#include <cstdint>
+#include <functional>
+
+// Reads single 32-bit pixels of a framebuffer without stalling the pipeline. glReadPixels copies
+// into one of a ring of pixel pack buffers and a fence marks the end of the copy. Poll() hands the
+// value to the callback once its fence has signaled, normally one or two frames later. Results
+// arrive in request order.
+class PixelReadback {
+public:
+	// attachment is GL_COLOR_ATTACHMENTi or GL_DEPTH_ATTACHMENT, format/type as for glReadPixels.
+	// Returns false when the pixel is outside width x height and nothing was read.
+	template <typename T>
+	bool Request(GLuint fbo, GLenum attachment, int x, int y, int width, int height, GLenum format, GLenum type, std::function<void(T)> callback) {
+		static_assert(sizeof(T) == sizeof(uint32_t), "one 32-bit pixel per request");
+		return RequestBits(fbo, attachment, x, y, width, height, format, type, [callback = std::move(callback)](uint32_t bits) { callback(std::bit_cast<T>(bits)); });
+	}
+	// delivers every finished read, call once per frame
+	void Poll();
+private:
+	bool RequestBits(GLuint fbo, GLenum attachment, int x, int y, int width, int height, GLenum format, GLenum type, std::function<void(uint32_t)> callback);
+	// reads slot index back and calls back, wait blocks until the copy is done
+	bool Deliver(int index, bool wait);
+
+	struct Slot {
+		GLuint buffer = 0;
+		GLsync fence = nullptr;
+		std::function<void(uint32_t)> callback;
+	};
+	static constexpr int sSlots = 4;
+	Slot mSlots[sSlots];
+	int mOldest = 0, mPending = 0;
+};
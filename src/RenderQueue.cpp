@@ -0,0 +1,204 @@
+#include "RenderQueue.h"
+#include <bit>
+
+void RenderQueue::Reset(const Vector3& eye)
+{
+	mEye = eye;
+	mPackets.clear();
+}
+
+void RenderQueue::Submit(const DrawPacket& packet)
+{
+	assert(packet.shader && packet.mesh && packet.model);
+	mPackets.push_back(packet);
+}
+
+uint32_t RenderQueue::Cull()
+{
+	mBounds.resize(mPackets.size());
+	for (size_t i = 0; i < mPackets.size(); ++i)
+		mBounds[i] = Math::Transform(mPackets[i].mesh->mBounds, *mPackets[i].model);
+
+	mVisible.resize(mPackets.size());
+	mCulled.clear();
+	uint32_t culled = 0;
+	for (size_t layer = 0; layer < mLayers.size(); ++layer)
+	{
+		culled += static_cast<uint32_t>(mPackets.size() - Math::Cull(mLayers[layer], mBounds, mVisible));
+		for (size_t i = 0; i < mPackets.size(); ++i)
+		{
+			if (!mVisible[i]) continue;
+			DrawPacket& routed = mCulled.emplace_back(mPackets[i]);
+			routed.layer = static_cast<int>(layer);
+		}
+	}
+	mPackets.swap(mCulled);
+	return culled;
+}
+
+uint64_t RenderQueue::MakeKey(const DrawPacket& packet) const
+{
+	// Only the order depends on these bits, batching compares the real state. A collision in the
+	// program or texture hash, or two meshes sharing the low 16 bits of their dense arena ID (only
+	// possible past 65536 live meshes), costs a redundant bind at worst
+	const uint64_t program = (std::hash<const Shader*>{}(packet.shader) * 0x9e3779b97f4a7c15ull) >> 56;
+	uint64_t textures = 0;
+	if (mBindMaterials)
+	{
+		const DrawMaterial& m = packet.material;
+		textures = ((uint64_t(m.albedoMap) * 0x9e3779b1u) ^ (uint64_t(m.normalMap) * 0x85ebca77u) ^ (uint64_t(m.roughnessMap) * 0xc2b2ae3du)) & 0xffff;
+	}
+	const uint64_t mesh = packet.mesh->mGeometry.id & 0xffff;
+
+	const Matrix4& model = *packet.model;
+	const Vector3 offset = Vector3(model[3].x, model[3].y, model[3].z) - mEye;
+	// the bits of a non-negative float sort like the float itself
+	const uint64_t depth = std::bit_cast<uint32_t>(Math::Dot(offset, offset)) >> 7;
+
+	return program << 56 | textures << 40 | mesh << 24 | depth;
+}
+
+// LSD radix sort on bytes, stable, so equal keys keep their submission order. Passes over a byte
+// that is the same in every key (common for the program byte) are skipped.
+void RenderQueue::RadixSort(vector<SortItem>& items, vector<SortItem>& scratch)
+{
+	scratch.resize(items.size());
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		uint32_t counts[256] = {};
+		for (const SortItem& item : items)
+			++counts[(item.key >> shift) & 0xff];
+		if (counts[(items[0].key >> shift) & 0xff] == items.size()) continue;
+
+		uint32_t offset = 0;
+		for (uint32_t& count : counts)
+		{
+			const uint32_t c = count;
+			count = offset;
+			offset += c;
+		}
+		for (const SortItem& item : items)
+			scratch[counts[(item.key >> shift) & 0xff]++] = item;
+		items.swap(scratch);
+	}
+}
+
+bool RenderQueue::CanBatch(const DrawPacket& a, const DrawPacket& b) const
+{
+	return a.shader == b.shader && a.mesh == b.mesh && (!mBindMaterials || a.material == b.material);
+}
+
+bool RenderQueue::SameTextures(const DrawPacket& a, const DrawPacket& b) const
+{
+	return !mBindMaterials || (a.material.albedoMap == b.material.albedoMap && a.material.normalMap == b.material.normalMap && a.material.roughnessMap == b.material.roughnessMap);
+}
+
+void RenderQueue::Upload(GLuint& buffer, GLenum target, const void* data, size_t size)
+{
+	if (!buffer) glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+	// orphan last frame's storage instead of waiting for the draws that still read it
+	glBufferData(target, size, data, GL_STREAM_DRAW);
+}
+
+RenderStats RenderQueue::Flush()
+{
+	RenderStats stats;
+	stats.tested = static_cast<uint32_t>(mPackets.size() * std::max<size_t>(mLayers.size(), 1));
+	if (!mLayers.empty()) stats.culled = Cull();
+	if (mPackets.empty()) return stats;
+
+	mItems.resize(mPackets.size());
+	for (uint32_t i = 0; i < mPackets.size(); ++i)
+		mItems[i] = { MakeKey(mPackets[i]), i };
+	RadixSort(mItems, mScratch);
+
+	// instance data in draw order, so every batch is a contiguous range starting at its base instance
+	mInstances.resize(mItems.size());
+	mCommands.clear();
+	mDraws.clear();
+	mCommandPackets.clear();
+	for (size_t first = 0, last = 0; first < mItems.size(); first = last)
+	{
+		const DrawPacket& packet = mPackets[mItems[first].index];
+		for (last = first; last < mItems.size() && CanBatch(packet, mPackets[mItems[last].index]); ++last)
+		{
+			const DrawPacket& instancePacket = mPackets[mItems[last].index];
+			InstanceData& instance = mInstances[last];
+			instance.model = *instancePacket.model;
+			for (int c = 0; c < 3; ++c)
+				instance.normal[c] = instancePacket.normal ? Vector4((*instancePacket.normal)[c], 0.0f) : Vector4(0.0f);
+			instance.entityID = instancePacket.entityID;
+			instance.skin = instancePacket.skin;
+			instance.emission = instancePacket.emission;
+			instance.layer = instancePacket.layer;
+		}
+
+		const GeometryRange& geometry = packet.mesh->mGeometry;
+		mCommands.push_back({ geometry.indexCount, static_cast<GLuint>(last - first), geometry.firstIndex, static_cast<GLint>(geometry.baseVertex), static_cast<GLuint>(first) });
+
+		const DrawMaterial& m = packet.material;
+		DrawData& draw = mDraws.emplace_back();
+		draw.albedo = m.albedo;
+		draw.metallic = m.metallic;
+		draw.roughness = m.roughness;
+		draw.emission = m.emission;
+		draw.uvScale = m.uvScale;
+		draw.useAlbedo = !m.albedoMap;
+		draw.useNormal = !m.normalMap;
+		draw.useRoughness = !m.roughnessMap;
+		draw._pad0 = 0;
+		mCommandPackets.push_back(&packet);
+	}
+
+	Upload(mInstanceBuffer, GL_SHADER_STORAGE_BUFFER, mInstances.data(), mInstances.size() * sizeof(InstanceData));
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, sInstanceBinding, mInstanceBuffer);
+	Upload(mDrawBuffer, GL_SHADER_STORAGE_BUFFER, mDraws.data(), mDraws.size() * sizeof(DrawData));
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, sDrawBinding, mDrawBuffer);
+	Upload(mIndirectBuffer, GL_DRAW_INDIRECT_BUFFER, mCommands.data(), mCommands.size() * sizeof(DrawElementsIndirectCommand));
+
+	GeometryArena::Get().Bind();
+	++stats.meshes;
+
+	// other passes touch GL state between flushes, so nothing is assumed to be bound yet
+	Shader* shader = nullptr;
+	GLuint bound[3] = {};
+	for (size_t first = 0, last = 0; first < mCommands.size(); first = last)
+	{
+		const DrawPacket& packet = *mCommandPackets[first];
+		for (last = first + 1; last < mCommands.size() && mCommandPackets[last]->shader == packet.shader && SameTextures(packet, *mCommandPackets[last]); ++last);
+
+		if (packet.shader != shader)
+		{
+			shader = packet.shader;
+			shader->Use();
+			++stats.programs;
+		}
+
+		if (mBindMaterials)
+		{
+			const DrawMaterial& m = packet.material;
+			const GLuint maps[3] = { m.albedoMap, m.normalMap, m.roughnessMap };
+			for (int unit = 0; unit < 3; ++unit)
+			{
+				// slot must >= 4, the first 4 slots are used by IBL and the shadow map
+				if (!maps[unit] || maps[unit] == bound[unit]) continue;
+				glActiveTexture(GL_TEXTURE4 + unit);
+				glBindTexture(GL_TEXTURE_2D, maps[unit]);
+				bound[unit] = maps[unit];
+				++stats.textures;
+			}
+		}
+
+		// gl_DrawID restarts at 0 in every call
+		shader->SetInt("uDrawBase", static_cast<int>(first));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(first * sizeof(DrawElementsIndirectCommand)), static_cast<GLsizei>(last - first), 0);
+		++stats.draws;
+	}
+	stats.commands = static_cast<uint32_t>(mCommands.size());
+	stats.instances = static_cast<uint32_t>(mInstances.size());
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+	return stats;
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include "Defines.h"
+#include "Model.h"
+#include "Shader.h"
+#include <cstdint>
+
+// Per-draw material state of the PBR shader. A map of 0 means the constant value is used instead
+// (uUseAlbedo/uUseNormal/uUseRoughness), the maps go to texture units 4-6. Draws with equal
+// materials of the same mesh are merged into one instanced draw.
+struct DrawMaterial {
+	GLuint albedoMap = 0, normalMap = 0, roughnessMap = 0;
+	Vector3 albedo = Vector3(1);
+	float metallic = 0.1f;
+	float roughness = 1.0f;
+	float emission = 0.0f;
+	Vector2 uvScale = Vector2(1, 1);
+
+	bool operator==(const DrawMaterial&) const = default;
+};
+
+// One mesh instance. The matrices are owned by the entity and have to stay alive until the queue
+// is flushed, everything below the material ends up in the instance buffer.
+struct DrawPacket {
+	Shader* shader = nullptr;
+	Mesh* mesh = nullptr;
+	DrawMaterial material;
+	const Matrix4* model = nullptr;
+	const Matrix3* normal = nullptr;
+	int entityID = -1;
+	int skin = -1;          // layer of the car skin array (unit 7), -1 keeps the material albedo
+	float emission = -1.0f; // replaces material.emission when >= 0, used to highlight selection
+	int layer = 0;          // framebuffer layer (cube face) when the vertex shader routes by gl_Layer
+};
+
+// std430 layout of one element of the InstanceData buffer in pbr.vs and shadow.vs
+struct InstanceData {
+	Matrix4 model;
+	Vector4 normal[3]; // mat3 columns padded to vec4
+	int32_t entityID;
+	int32_t skin;
+	float emission;
+	int32_t layer;
+};
+static_assert(sizeof(InstanceData) == 128);
+
+// std430 layout of one element of the DrawData buffer in pbr.vs/pbr.fs, the material of one
+// indirect command, found with uDrawBase + gl_DrawID
+struct DrawData {
+	Vector3 albedo;
+	float metallic;
+	float roughness;
+	float emission;
+	Vector2 uvScale;
+	int32_t useAlbedo, useNormal, useRoughness;
+	int32_t _pad0;
+};
+static_assert(sizeof(DrawData) == 48 && offsetof(DrawData, uvScale) == 24);
+
+// glMultiDrawElementsIndirect command, layout fixed by GL
+struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// What Flush actually sent to GL, summed over the frame by Engine for the HUD
+struct RenderStats {
+	uint32_t draws = 0;    // GL draw calls
+	uint32_t commands = 0; // indirect commands, one per mesh batch
+	uint32_t instances = 0;
+	uint32_t programs = 0;
+	uint32_t meshes = 0;
+	uint32_t textures = 0;
+	uint32_t tested = 0;   // packet/frustum pairs tested, packets submitted without frusta
+	uint32_t culled = 0;   // pairs that failed the test
+
+	uint32_t StateChanges() const { return programs + meshes + textures; }
+	RenderStats& operator+=(const RenderStats& other) {
+		tested += other.tested;
+		culled += other.culled;
+		draws += other.draws;
+		commands += other.commands;
+		instances += other.instances;
+		programs += other.programs;
+		meshes += other.meshes;
+		textures += other.textures;
+		return *this;
+	}
+};
+
+// Collects the draws of one pass, sorts them by a 64-bit key and issues them skipping every bind
+// that would not change anything. Key layout, most significant first:
+//   63-56 program   55-40 texture set   39-24 mesh   23-0 squared distance to the eye
+// so state changes are minimized first and equal state is drawn front to back for early-z.
+// Runs of packets that differ only in their instance data become one indirect command (the
+// shaders index the instance buffer with gl_BaseInstance + gl_InstanceID), and consecutive
+// commands with the same program and textures go out as one glMultiDrawElementsIndirect over the
+// GeometryArena. Depth-only queues (shadow) ignore the material, so they are a single call.
+class RenderQueue {
+public:
+	// shader storage bindings of InstanceData and DrawData
+	static constexpr GLuint sInstanceBinding = 0;
+	static constexpr GLuint sDrawBinding = 1;
+	static constexpr int sSkinUnit = 7;
+
+	explicit RenderQueue(bool bindMaterials = true) : mBindMaterials(bindMaterials) {}
+
+	// drops last frame's packets, eye is the camera (or light) position used for the depth bits
+	void Reset(const Vector3& eye);
+	// With layers set, Flush keeps a packet once for every frustum its world bounds touch, with
+	// DrawPacket::layer set to that frustum's index, and drops it when it touches none. One frustum
+	// is plain view frustum culling, six route shadow casters to the cube faces they can shadow.
+	// The bounds are tested in one Math::Cull batch per frustum.
+	void SetLayers(std::span<const Frustum> layers) { mLayers.assign(layers.begin(), layers.end()); }
+	void Submit(const DrawPacket& packet);
+	// sorts and draws everything submitted since Reset, the GL state tracking starts fresh
+	RenderStats Flush();
+
+	size_t Size() const { return mPackets.size(); }
+
+private:
+	struct SortItem {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	// replaces mPackets by the packets that pass the layer frusta, returns the failed tests
+	uint32_t Cull();
+	uint64_t MakeKey(const DrawPacket& packet) const;
+	bool CanBatch(const DrawPacket& a, const DrawPacket& b) const;
+	bool SameTextures(const DrawPacket& a, const DrawPacket& b) const;
+	static void RadixSort(vector<SortItem>& items, vector<SortItem>& scratch);
+	// orphans and refills a buffer, generating it on first use
+	static void Upload(GLuint& buffer, GLenum target, const void* data, size_t size);
+
+	bool mBindMaterials;
+	Vector3 mEye = Vector3(0);
+	vector<Frustum> mLayers;
+	vector<DrawPacket> mPackets, mCulled;
+	vector<AABB> mBounds;
+	vector<uint8_t> mVisible;
+	vector<SortItem> mItems, mScratch;
+	vector<InstanceData> mInstances;
+	vector<DrawElementsIndirectCommand> mCommands;
+	vector<DrawData> mDraws;
+	vector<const DrawPacket*> mCommandPackets; // first packet of each command
+	GLuint mInstanceBuffer = 0, mDrawBuffer = 0, mIndirectBuffer = 0;
+};
@@ -0,0 +1,81 @@
+#include "ResourceManager.h"
+#include <filesystem>
+
+ResourceManager& ResourceManager::Get()
+{
+	static ResourceManager sInstance;
+	return sInstance;
+}
+
+string ResourceManager::NormalizePath(const string& path)
+{
+	if (path.empty()) return path;
+	return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+template <typename T, typename Load>
+shared_ptr<T> ResourceManager::Acquire(unordered_map<string, std::weak_ptr<T>>& cache, const string& key, Load&& load)
+{
+	++mStats.requests;
+	auto it = cache.find(key);
+	if (it != cache.end())
+	{
+		if (shared_ptr<T> resource = it->second.lock())
+		{
+			++mStats.hits;
+			return resource;
+		}
+		++mStats.evictions;
+	}
+	shared_ptr<T> resource = load();
+	cache[key] = resource;
+	++mStats.loads;
+	return resource;
+}
+
+ModelPtr ResourceManager::GetModel(const string& path)
+{
+	const string file = NormalizePath(path);
+	return Acquire(mModels, file, [&] { return make_shared<Model>(file); });
+}
+
+Texture2DPtr ResourceManager::GetTexture2D(const string& path, bool gamma)
+{
+	const string file = NormalizePath(path);
+	return Acquire(mTextures, file + (gamma ? "|gamma" : ""), [&] { return make_shared<Texture2D>(file, gamma); });
+}
+
+Texture2DArrayPtr ResourceManager::GetTexture2DArray(const vector<string>& paths)
+{
+	vector<string> files;
+	string key;
+	for (auto& path : paths)
+	{
+		files.push_back(NormalizePath(path));
+		key += files.back() + "|";
+	}
+	return Acquire(mTextureArrays, key, [&] { return make_shared<Texture2DArray>(files); });
+}
+
+TextureCubePtr ResourceManager::GetTextureCube(const string& name, int width, int height)
+{
+	return Acquire(mTextureCubes, std::format("{}|{}x{}", name, width, height), [&] { return make_shared<TextureCube>(width, height); });
+}
+
+ShaderPtr ResourceManager::GetShader(const string& vertexPath, const string& fragmentPath, const string& geometryPath)
+{
+	const string vs = NormalizePath(vertexPath), fs = NormalizePath(fragmentPath), gs = NormalizePath(geometryPath);
+	return Acquire(mShaders, vs + "|" + fs + "|" + gs, [&] { return make_shared<Shader>(vs, fs, gs); });
+}
+
+void ResourceManager::Collect()
+{
+	auto collect = [this](auto& cache) {
+		mStats.evictions += std::erase_if(cache, [](const auto& entry) { return entry.second.expired(); });
+	};
+	collect(mModels);
+	collect(mTextures);
+	collect(mTextureArrays);
+	collect(mTextureCubes);
+	collect(mShaders);
+}
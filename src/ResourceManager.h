@@ -0,0 +1,46 @@
+#pragma once
+#include "Defines.h"
+#include "Model.h"
+#include "Shader.h"
+
+// Shared, path-keyed cache of everything loaded from disk (or created by name, for the cube map
+// render targets). Entries are weak: a resource lives as long as someone holds its shared_ptr and
+// is loaded again on the next request after that. Meshes and textures are shared, so never change
+// one in place for a single user (per-object materials belong to the object, see Wall::mMaterial).
+class ResourceManager {
+public:
+	struct Stats {
+		size_t requests = 0;
+		size_t hits = 0;      // served from the cache
+		size_t loads = 0;     // went to disk or created GPU objects
+		size_t evictions = 0; // entries found expired
+	};
+
+	static ResourceManager& Get();
+
+	ModelPtr GetModel(const string& path);
+	Texture2DPtr GetTexture2D(const string& path, bool gamma = false);
+	Texture2DArrayPtr GetTexture2DArray(const vector<string>& paths);
+	TextureCubePtr GetTextureCube(const string& name, int width, int height);
+	ShaderPtr GetShader(const string& vertexPath, const string& fragmentPath, const string& geometryPath = EMPTY);
+
+	// drops expired entries, the maps otherwise only shrink when an expired key is requested again
+	void Collect();
+	const Stats& GetStats() const { return mStats; }
+
+	// "asset/model/../model/car.obj" and "asset\\model\\car.obj" name the same file
+	static string NormalizePath(const string& path);
+
+private:
+	ResourceManager() = default;
+
+	template <typename T, typename Load>
+	shared_ptr<T> Acquire(unordered_map<string, std::weak_ptr<T>>& cache, const string& key, Load&& load);
+
+	unordered_map<string, std::weak_ptr<Model>> mModels;
+	unordered_map<string, std::weak_ptr<Texture2D>> mTextures;
+	unordered_map<string, std::weak_ptr<Texture2DArray>> mTextureArrays;
+	unordered_map<string, std::weak_ptr<TextureCube>> mTextureCubes;
+	unordered_map<string, std::weak_ptr<Shader>> mShaders;
+	Stats mStats;
+};
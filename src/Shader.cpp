@@ -1,4 +1,8 @@
 #include "Shader.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
 
 Shader::Shader(const string& vertexPath, const string& fragmentPath, const string& geometryPath)
 {
@@ -86,6 +90,8 @@ Shader::Shader(const string& vertexPath, const string& fragmentPath, const strin
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
 	if (geometry) glDeleteShader(geometry);
+
+	ReflectUniforms();
 }
 
 void Shader::Use()
@@ -93,37 +99,126 @@ void Shader::Use()
 	glUseProgram(mID);
 }
 
-void Shader::SetInt(const std::string& name, int value)
+UniformHandle Shader::GetUniform(UniformName name) const
 {
-	glUniform1i(glGetUniformLocation(mID, name.c_str()), value);
+	if (mSlots.empty()) return {};
+	const uint32_t hash = name.GetHash();
+	const size_t mask = mSlots.size() - 1;
+	for (size_t slot = hash & mask; mSlots[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		if (mUniforms[mSlots[slot]].hash == hash)
+		{
+			// active uniforms never collide (ReflectUniforms), this catches a name that is not active
+			assert(mUniforms[mSlots[slot]].name == name.GetName() && "uniform name hash collision");
+			return { mSlots[slot] };
+		}
+	}
+	return {};
 }
 
-void Shader::SetBool(const std::string& name, bool value)
+template <typename T>
+Shader::Uniform* Shader::Changed(UniformHandle handle, const T& value)
 {
-	glUniform1i(glGetUniformLocation(mID, name.c_str()), (int)value);
+	static_assert(sizeof(T) <= sizeof(Uniform::value));
+	if (!handle.IsValid()) return nullptr;
+	Uniform& uniform = mUniforms[handle.index];
+	if (uniform.cached && std::memcmp(uniform.value, &value, sizeof(T)) == 0) return nullptr;
+	std::memcpy(uniform.value, &value, sizeof(T));
+	uniform.cached = true;
+	return &uniform;
 }
 
-void Shader::SetFloat(const std::string& name, float value)
+void Shader::SetInt(UniformHandle handle, int value)
 {
-	glUniform1f(glGetUniformLocation(mID, name.c_str()), value);
+	if (Uniform* uniform = Changed(handle, value))
+		glUniform1i(uniform->location, value);
 }
-void Shader::SetFloat2(const std::string& name, const Vector2& value)
+
+void Shader::SetBool(UniformHandle handle, bool value)
 {
-	glUniform2fv(glGetUniformLocation(mID, name.c_str()), 1,Math::Ptr(value));
+	SetInt(handle, (int)value);
 }
-void Shader::SetFloat3(const std::string& name, const Vector3& value)
+
+void Shader::SetFloat(UniformHandle handle, float value)
 {
-	glUniform3fv(glGetUniformLocation(mID, name.c_str()), 1, Math::Ptr(value));
+	if (Uniform* uniform = Changed(handle, value))
+		glUniform1f(uniform->location, value);
+}
+void Shader::SetFloat2(UniformHandle handle, const Vector2& value)
+{
+	if (Uniform* uniform = Changed(handle, value))
+		glUniform2fv(uniform->location, 1, Math::Ptr(value));
+}
+void Shader::SetFloat3(UniformHandle handle, const Vector3& value)
+{
+	if (Uniform* uniform = Changed(handle, value))
+		glUniform3fv(uniform->location, 1, Math::Ptr(value));
 }
 
-void Shader::SetMat3(const std::string& name, const Matrix3& value)
+void Shader::SetMat3(UniformHandle handle, const Matrix3& value)
 {
-	glUniformMatrix3fv(glGetUniformLocation(mID, name.c_str()), 1, GL_FALSE, Math::Ptr(value));
+	if (Uniform* uniform = Changed(handle, value))
+		glUniformMatrix3fv(uniform->location, 1, GL_FALSE, Math::Ptr(value));
 }
 
-void Shader::SetMat4(const std::string& name, const Matrix4& value)
+void Shader::SetMat4(UniformHandle handle, const Matrix4& value)
 {
-	glUniformMatrix4fv(glGetUniformLocation(mID, name.c_str()), 1, GL_FALSE, Math::Ptr(value));
+	if (Uniform* uniform = Changed(handle, value))
+		glUniformMatrix4fv(uniform->location, 1, GL_FALSE, Math::Ptr(value));
+}
+
+void Shader::SetMat4(UniformHandle handle, std::span<const Matrix4> values)
+{
+	if (!handle.IsValid() || values.empty()) return;
+	// arrays are not cached, element 0 may be set on its own and partial uploads are legal
+	Uniform& uniform = mUniforms[handle.index];
+	uniform.cached = false;
+	glUniformMatrix4fv(uniform.location, (GLsizei)std::min<size_t>(values.size(), uniform.size), GL_FALSE, Math::Ptr(values[0]));
+}
+
+void Shader::ReflectUniforms()
+{
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(mID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(mID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::string name(std::max(maxLength, 1), '\0');
+	vector<string> names;
+	for (GLint i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+		Uniform uniform{};
+		glGetActiveUniform(mID, i, maxLength, &length, &uniform.size, &uniform.type, name.data());
+		std::string_view view(name.data(), length);
+		// members of uniform blocks have no location
+		uniform.location = glGetUniformLocation(mID, name.c_str());
+		if (uniform.location < 0) continue;
+		if (view.ends_with("[0]")) view.remove_suffix(3);
+		uniform.hash = HashUniformName(view);
+#ifndef NDEBUG
+		uniform.name = view;
+#endif
+		mUniforms.push_back(uniform);
+		names.emplace_back(view);
+	}
+
+	size_t slots = 1;
+	while (slots < mUniforms.size() * 2) slots <<= 1;
+	mSlots.assign(slots, -1);
+	for (size_t i = 0; i < mUniforms.size(); ++i)
+	{
+		size_t slot = mUniforms[i].hash & (slots - 1);
+		for (; mSlots[slot] >= 0; slot = (slot + 1) & (slots - 1))
+		{
+			if (mUniforms[mSlots[slot]].hash == mUniforms[i].hash)
+			{
+				// lookups only compare hashes, setting one of them would silently write the other
+				INFO("ERROR::SHADER::UNIFORM_HASH_COLLISION {} and {} both hash to {:#010x}, rename one", names[mSlots[slot]], names[i], mUniforms[i].hash);
+				std::abort();
+			}
+		}
+		mSlots[slot] = (int16_t)i;
+	}
 }
 
 void Shader::CheckCompileErrors(GLuint shader, std::string type)
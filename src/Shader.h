@@ -2,24 +2,109 @@
 #include "Defines.h"
 #include "math/Matrix.h"
 #include "glad/glad.h"
+#include <cstdint>
+#include <span>
 
 const string EMPTY = "";
+
+// FNV-1a, usable at compile time so uniform names in the source never reach the driver
+constexpr uint32_t HashUniformName(std::string_view name)
+{
+	uint32_t hash = 0x811c9dc5u;
+	for (char c : name)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 0x01000193u;
+	}
+	return hash;
+}
+
+// A uniform name reduced to its hash. String literals convert implicitly and are hashed at compile
+// time (SetMat4("uModel", ...)); names built at runtime have to go through the explicit constructor.
+// Debug builds keep the name too, so GetUniform can tell a hash collision from a match.
+class UniformName {
+public:
+	template <size_t N>
+	consteval UniformName(const char (&name)[N]) : mHash(HashUniformName(std::string_view(name, N - 1)))
+#ifndef NDEBUG
+		, mName(name, N - 1)
+#endif
+	{}
+	explicit UniformName(std::string_view name) : mHash(HashUniformName(name))
+#ifndef NDEBUG
+		, mName(name)
+#endif
+	{}
+
+	uint32_t GetHash() const { return mHash; }
+#ifndef NDEBUG
+	std::string_view GetName() const { return mName; }
+#endif
+
+private:
+	uint32_t mHash;
+#ifndef NDEBUG
+	std::string_view mName; // a literal or the caller's string, only read during the call
+#endif
+};
+
+// Index into the uniform table of one Shader, skips even the hash probe. Invalid (-1) when the
+// uniform is not active in the program, setters then do nothing, like GL does for location -1.
+struct UniformHandle {
+	int index = -1;
+
+	bool IsValid() const { return index >= 0; }
+};
+
 using ShaderPtr = shared_ptr<class Shader>;
 class Shader {
 public:
 	Shader(const string& vertexPath, const string& fragmentPath, const string& geometryPath = EMPTY);
 
 	void Use();
-	void SetInt(const std::string& name, int value);
-	void SetBool(const std::string& name, bool value);
-	void SetFloat(const std::string& name, float value);
-	void SetFloat2(const std::string& name, const Vector2& value);
-	void SetFloat3(const std::string& name, const Vector3& value);
-	void SetMat3(const std::string& name, const Matrix3& value);
-	void SetMat4(const std::string& name, const Matrix4& value);
+	UniformHandle GetUniform(UniformName name) const;
+
+	void SetInt(UniformName name, int value) { SetInt(GetUniform(name), value); }
+	void SetBool(UniformName name, bool value) { SetBool(GetUniform(name), value); }
+	void SetFloat(UniformName name, float value) { SetFloat(GetUniform(name), value); }
+	void SetFloat2(UniformName name, const Vector2& value) { SetFloat2(GetUniform(name), value); }
+	void SetFloat3(UniformName name, const Vector3& value) { SetFloat3(GetUniform(name), value); }
+	void SetMat3(UniformName name, const Matrix3& value) { SetMat3(GetUniform(name), value); }
+	void SetMat4(UniformName name, const Matrix4& value) { SetMat4(GetUniform(name), value); }
+	// whole array in one call, starting at element 0 ("shadowMatrices")
+	void SetMat4(UniformName name, std::span<const Matrix4> values) { SetMat4(GetUniform(name), values); }
+
+	void SetInt(UniformHandle handle, int value);
+	void SetBool(UniformHandle handle, bool value);
+	void SetFloat(UniformHandle handle, float value);
+	void SetFloat2(UniformHandle handle, const Vector2& value);
+	void SetFloat3(UniformHandle handle, const Vector3& value);
+	void SetMat3(UniformHandle handle, const Matrix3& value);
+	void SetMat4(UniformHandle handle, const Matrix4& value);
+	void SetMat4(UniformHandle handle, std::span<const Matrix4> values);
 	
 private:
+	// One active uniform, arrays are a single entry named without the "[0]" suffix
+	struct Uniform {
+		uint32_t hash;
+		GLint location;
+		GLenum type;
+		GLint size;
+		// last value uploaded through this Shader, uniforms are program state so it stays valid
+		bool cached = false;
+		float value[16];
+#ifndef NDEBUG
+		std::string name;
+#endif
+	};
+
 	GLuint mID;
+	vector<Uniform> mUniforms;
+	// open addressing on the name hash, power of two size, -1 marks an empty slot
+	vector<int16_t> mSlots;
+
 	void CheckCompileErrors(GLuint shader, std::string type);
+	void ReflectUniforms();
+	template <typename T>
+	Uniform* Changed(UniformHandle handle, const T& value);
 };
-
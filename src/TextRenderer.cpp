@@ -1,4 +1,5 @@
 #include "TextRenderer.h"
+#include "ResourceManager.h"
 #include "glad/glad.h"
 
 
@@ -79,7 +80,7 @@ TextRenderer::TextRenderer(int width, int height)
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
-	mShader = make_shared<class Shader>("asset/shader/text.vs", "asset/shader/text.fs");
+	mShader = ResourceManager::Get().GetShader("asset/shader/text.vs", "asset/shader/text.fs");
 	glDisable(GL_CULL_FACE);
 }
 
@@ -0,0 +1,52 @@
+#include "TransformStore.h"
+#include "math/Math.h"
+
+TransformStore& TransformStore::Get()
+{
+	static TransformStore sInstance;
+	return sInstance;
+}
+
+uint32_t TransformStore::Add(const Vector3& position, float theta, const Vector3& scale)
+{
+	uint32_t index;
+	if (!mFreeIndices.empty())
+	{
+		index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(mPositions.size());
+		mPositions.emplace_back();
+		mThetas.emplace_back();
+		mScales.emplace_back();
+		mModelMatrices.emplace_back();
+		mNormalMatrices.emplace_back();
+	}
+	mPositions[index] = position;
+	mThetas[index] = theta;
+	mScales[index] = scale;
+	return index;
+}
+
+void TransformStore::Free(uint32_t index)
+{
+	// still composed every frame until reused, keep the reciprocal finite
+	mScales[index] = Vector3::ONE;
+	mFreeIndices.push_back(index);
+}
+
+void TransformStore::Update()
+{
+	const size_t count = mPositions.size();
+	mInverseScales.resize(count);
+	mRotationScales.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+		mInverseScales[i] = 1.0f / mScales[i];
+	Math::ComposeTRS(mPositions, mThetas, mScales, mModelMatrices);
+	Math::ComposeTRS(mPositions, mThetas, mInverseScales, mRotationScales);
+	for (size_t i = 0; i < count; ++i)
+		mNormalMatrices[i] = Matrix3(mRotationScales[i]);
+}
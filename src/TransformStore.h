@@ -0,0 +1,40 @@
+#pragma once
+#include "Defines.h"
+#include "math/Matrix.h"
+#include <cstdint>
+
+// Position, angle around +Y and scale of every car and wall, kept as separate arrays. This is the
+// only copy: entities hold an index and read and write through it, so Update runs straight over
+// the arrays with one Math::ComposeTRS for the model matrices. The normal matrix of T * R * S is
+// R * S^-1, a second ComposeTRS over the reciprocal scales builds it without inverting anything.
+class TransformStore {
+public:
+	static TransformStore& Get();
+
+	uint32_t Add(const Vector3& position = Vector3::ZERO, float theta = 0.0f, const Vector3& scale = Vector3::ONE);
+	// the index is handed out again by a later Add
+	void Free(uint32_t index);
+
+	Vector3& Position(uint32_t index) { return mPositions[index]; }
+	float& Theta(uint32_t index) { return mThetas[index]; } // angle to -z
+	Vector3& Scale(uint32_t index) { return mScales[index]; }
+
+	// as of the last Update, Add may move them
+	const Matrix4& GetModelMatrix(uint32_t index) const { return mModelMatrices[index]; }
+	const Matrix3& GetNormalMatrix(uint32_t index) const { return mNormalMatrices[index]; }
+
+	// rebuilds every matrix, once per frame before anything is submitted
+	void Update();
+
+private:
+	TransformStore() = default;
+
+	vector<Vector3> mPositions, mScales;
+	vector<float> mThetas;
+	vector<Matrix4> mModelMatrices;
+	vector<Matrix3> mNormalMatrices;
+	// Update scratch
+	vector<Vector3> mInverseScales;
+	vector<Matrix4> mRotationScales;
+	vector<uint32_t> mFreeIndices;
+};
@@ -0,0 +1,28 @@
+#include "UniformBuffer.h"
+#include <cstring>
+
+UniformBuffer::UniformBuffer(GLuint binding, size_t size)
+	: mBinding(binding), mData(size)
+{
+	glGenBuffers(1, &mID);
+	glBindBuffer(GL_UNIFORM_BUFFER, mID);
+	glBufferData(GL_UNIFORM_BUFFER, size, mData.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	Bind();
+}
+
+void UniformBuffer::Update(const void* data, size_t size)
+{
+	assert(size == mData.size());
+	if (std::memcmp(mData.data(), data, size) == 0) return;
+	std::memcpy(mData.data(), data, size);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, mID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::Bind()
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, mBinding, mID);
+}
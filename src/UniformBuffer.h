@@ -0,0 +1,64 @@
+#pragma once
+#include "Defines.h"
+#include "math/Matrix.h"
+#include "glad/glad.h"
+#include <cstddef>
+
+// Binding points shared by every program. The blocks below are declared with the same
+// layout(std140, binding = N) in the shaders under asset/shader, keep both sides in sync.
+enum UniformBinding : GLuint {
+	FrameBinding = 0,
+	ViewBinding = 1,
+	LightBinding = 2,
+	ShadowBinding = 3,
+};
+
+// std140: scalars align to 4, vec2 to 8, vec3/vec4 and matrix columns to 16
+struct FrameData {
+	float uTime;
+	float uDeltaTime;
+	Vector2 uViewportSize;
+};
+
+struct ViewData {
+	Matrix4 uViewProjection;
+	Matrix4 uView;
+	Matrix4 uProjection;
+	Vector3 uCamPos;
+	float _pad0;
+};
+
+struct LightData {
+	Vector3 uLightPos;
+	float uFarPlane; // shadow far plane, fills the vec3 padding
+	int uShadowTaps; // PCF taps in pbr.fs: 1, 4, 8 or 16
+	float _pad0[3];
+};
+
+struct ShadowData {
+	Matrix4 uShadowMatrices[6];
+};
+
+static_assert(sizeof(FrameData) == 16 && offsetof(FrameData, uViewportSize) == 8);
+static_assert(sizeof(ViewData) == 208 && offsetof(ViewData, uCamPos) == 192);
+static_assert(sizeof(LightData) == 32 && offsetof(LightData, uFarPlane) == 12 && offsetof(LightData, uShadowTaps) == 16);
+static_assert(sizeof(ShadowData) == 384);
+
+using UniformBufferPtr = shared_ptr<class UniformBuffer>;
+class UniformBuffer {
+public:
+	UniformBuffer(GLuint binding, size_t size);
+
+	// re-uploads only when the contents changed
+	template <typename T>
+	void Update(const T& data) { Update(&data, sizeof(T)); }
+	void Update(const void* data, size_t size);
+	// glBindBufferBase to the fixed binding point
+	void Bind();
+
+	GLuint GetID() { return mID; }
+private:
+	GLuint mID = 0;
+	GLuint mBinding;
+	vector<std::byte> mData;
+};
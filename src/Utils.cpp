@@ -23,8 +23,16 @@ unsigned int Utils::LoadTexture(const string& path, bool gamma)
 		if (hdr) {
 			format = GL_RGBA16F;
 
+			// the texture is 16-bit anyway, converting here halves the upload
+			const size_t count = size_t(width) * height * nrComponents;
+			vector<Half> halves(count);
+			Math::PackHalf({ static_cast<const float*>(data), count }, halves);
+			const GLenum layout = nrComponents == 4 ? GL_RGBA : nrComponents == 3 ? GL_RGB : nrComponents == 2 ? GL_RG : GL_RED;
+
 			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGB, GL_FLOAT, data);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, layout, GL_HALF_FLOAT, halves.data());
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 			
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
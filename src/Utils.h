@@ -4,6 +4,7 @@
 #include "GLFW/glfw3.h"
 #include "glad/glad.h"
 #include "math/Math.h"
+#include "math/Packed.h"
 
 #include "stb_image.h"
 
@@ -0,0 +1,137 @@
+#pragma once
+#include "math/Geometry.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Bounding volume hierarchy over boxes for ray queries, e.g. picking. Build splits at the median
+// centroid along the longest axis, Refit keeps that topology and only updates the bounds, which
+// is enough as long as the boxes move a little between builds. Leaves keep their boxes next to
+// each other so they are tested with the SIMD Math::Raycast.
+
+class Bvh {
+public:
+	static constexpr uint32_t LEAF_SIZE = 4;
+
+	inline void Build(std::span<const AABB> boxes);
+	// boxes in the same order and count as in Build
+	inline void Refit(std::span<const AABB> boxes);
+	// Index (into the Build span) of the closest box hit by the ray within tMax, or -1. t receives
+	// the entry distance.
+	inline int Raycast(const Ray& ray, float& t, float tMax = Math::POS_INFINITY) const;
+
+	size_t Size() const { return mIndices.size(); }
+
+private:
+	// count == 0: interior node, children at first and first + 1. Otherwise a leaf over
+	// mBoxes[first, first + count). Children always come after their parent.
+	struct Node {
+		AABB bounds;
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+	inline void Split(uint32_t node, std::span<const AABB> boxes);
+
+	std::vector<Node> mNodes;
+	std::vector<AABB> mBoxes;       // in leaf order
+	std::vector<uint32_t> mIndices; // leaf order -> Build order
+};
+
+/***********************************************************************
+**************************** Implementation ***************************
+***********************************************************************/
+
+inline void Bvh::Build(std::span<const AABB> boxes) {
+	mNodes.clear();
+	mIndices.resize(boxes.size());
+	std::iota(mIndices.begin(), mIndices.end(), 0u);
+	mBoxes.resize(boxes.size());
+	if (boxes.empty()) return;
+
+	mNodes.reserve(2 * (boxes.size() / LEAF_SIZE + 1));
+	mNodes.push_back({ AABB(), 0, static_cast<uint32_t>(boxes.size()) });
+	Split(0, boxes);
+	Refit(boxes);
+}
+
+inline void Bvh::Split(uint32_t node, std::span<const AABB> boxes) {
+	const uint32_t first = mNodes[node].first, count = mNodes[node].count;
+	if (count <= LEAF_SIZE) return;
+
+	AABB centroids;
+	for (uint32_t i = first; i < first + count; ++i)
+		centroids.Merge(boxes[mIndices[i]].Center());
+	const Vector3 size = centroids.max - centroids.min;
+	const int axis = size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2;
+
+	const uint32_t half = count / 2;
+	std::nth_element(mIndices.begin() + first, mIndices.begin() + first + half, mIndices.begin() + first + count,
+		[&](uint32_t a, uint32_t b) { return boxes[a].Center()[axis] < boxes[b].Center()[axis]; });
+
+	const uint32_t left = static_cast<uint32_t>(mNodes.size());
+	mNodes.push_back({ AABB(), first, half });
+	mNodes.push_back({ AABB(), first + half, count - half });
+	mNodes[node].first = left;
+	mNodes[node].count = 0;
+	Split(left, boxes);
+	Split(left + 1, boxes);
+}
+
+inline void Bvh::Refit(std::span<const AABB> boxes) {
+	assert(boxes.size() == mIndices.size());
+	for (size_t i = 0; i < mIndices.size(); ++i)
+		mBoxes[i] = boxes[mIndices[i]];
+
+	// children come after their parents, so walking backwards sees them first
+	for (size_t i = mNodes.size(); i-- > 0;) {
+		Node& node = mNodes[i];
+		node.bounds = AABB();
+		if (node.count > 0) {
+			for (uint32_t j = node.first; j < node.first + node.count; ++j)
+				node.bounds.Merge(mBoxes[j]);
+		}
+		else {
+			node.bounds.Merge(mNodes[node.first].bounds);
+			node.bounds.Merge(mNodes[node.first + 1].bounds);
+		}
+	}
+}
+
+inline int Bvh::Raycast(const Ray& ray, float& t, float tMax) const {
+	if (mNodes.empty()) return -1;
+
+	int closest = -1;
+	float entry = 0.0f;
+	uint32_t stack[64];
+	int top = 0;
+	if (Math::Intersects(ray, mNodes[0].bounds, entry, tMax)) stack[top++] = 0;
+	while (top > 0) {
+		const Node& node = mNodes[stack[--top]];
+		if (node.count > 0) {
+			float hitT = 0.0f;
+			const int hit = Math::Raycast(ray, std::span<const AABB>(mBoxes.data() + node.first, node.count), hitT, tMax);
+			if (hit >= 0 && hitT < tMax) {
+				tMax = hitT;
+				closest = static_cast<int>(mIndices[node.first + hit]);
+			}
+			continue;
+		}
+
+		// push the farther child first so the nearer one is visited first and shrinks tMax
+		float t0 = 0.0f, t1 = 0.0f;
+		const bool hit0 = Math::Intersects(ray, mNodes[node.first].bounds, t0, tMax);
+		const bool hit1 = Math::Intersects(ray, mNodes[node.first + 1].bounds, t1, tMax);
+		if (hit0 && hit1) {
+			const bool nearFirst = t0 <= t1;
+			stack[top++] = node.first + (nearFirst ? 1 : 0);
+			stack[top++] = node.first + (nearFirst ? 0 : 1);
+		}
+		else if (hit0) stack[top++] = node.first;
+		else if (hit1) stack[top++] = node.first + 1;
+		assert(top < 64);
+	}
+	if (closest >= 0) t = tMax;
+	return closest;
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include "math/Math.h"
+#include <bit>
+#include <cstdint>
+
+// Opt-in deterministic simulation math. Fixed is a Q16.16 scalar built on integer arithmetic only,
+// with its own trig/sqrt/log, so a simulation templated on it gives bit-identical state on every
+// compiler, flag set and CPU. Build with MATH_DETERMINISTIC (xmake f --deterministic=y) to run the
+// car simulation on Fixed, otherwise SimScalar is float and uses libm.
+
+class Fixed {
+public:
+	static constexpr int FRACTION_BITS = 16;
+	static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+	int32_t raw = 0;
+
+public:
+	constexpr Fixed() noexcept = default;
+	constexpr explicit Fixed(int v) noexcept : raw(v * ONE) {}
+	// only meant for constants and for quantizing input once, the simulation itself never touches floats
+	constexpr explicit Fixed(float v) noexcept : raw(static_cast<int32_t>(v * ONE + (v < 0 ? -0.5f : 0.5f))) {}
+
+	static constexpr Fixed FromRaw(int32_t raw) noexcept {
+		Fixed f;
+		f.raw = raw;
+		return f;
+	}
+
+	constexpr explicit operator float() const noexcept { return static_cast<float>(raw) / ONE; }
+
+	// -- Unary arithmetic operators --
+	constexpr Fixed& operator+=(Fixed v) noexcept {
+		raw += v.raw;
+		return *this;
+	}
+	constexpr Fixed& operator-=(Fixed v) noexcept {
+		raw -= v.raw;
+		return *this;
+	}
+	constexpr Fixed& operator*=(Fixed v) noexcept {
+		raw = static_cast<int32_t>((int64_t(raw) * v.raw) >> FRACTION_BITS);
+		return *this;
+	}
+	constexpr Fixed& operator/=(Fixed v) noexcept {
+		assert(v.raw != 0);
+		raw = static_cast<int32_t>((int64_t(raw) << FRACTION_BITS) / v.raw);
+		return *this;
+	}
+
+	constexpr auto operator<=>(const Fixed&) const noexcept = default;
+};
+
+// -- Unary operators --
+constexpr Fixed operator+(Fixed v) noexcept { return v; }
+constexpr Fixed operator-(Fixed v) noexcept { return Fixed::FromRaw(-v.raw); }
+// -- Binary operators --
+constexpr Fixed operator+(Fixed a, Fixed b) noexcept { return a += b; }
+constexpr Fixed operator-(Fixed a, Fixed b) noexcept { return a -= b; }
+constexpr Fixed operator*(Fixed a, Fixed b) noexcept { return a *= b; }
+constexpr Fixed operator/(Fixed a, Fixed b) noexcept { return a /= b; }
+
+namespace Math {
+	namespace Detail {
+		// The functions below evaluate in Q2.28 on int64 so rounding stays well below one Q16.16 step
+		constexpr int Q = 28;
+		constexpr int64_t ToQ(double v) { return static_cast<int64_t>(v * (int64_t(1) << Q) + (v < 0 ? -0.5 : 0.5)); }
+		constexpr int64_t MulQ(int64_t a, int64_t b) { return (a * b) >> Q; }
+		constexpr int64_t FromFixed(Fixed v) { return int64_t(v.raw) << (Q - Fixed::FRACTION_BITS); }
+		constexpr Fixed ToFixed(int64_t q) { return Fixed::FromRaw(static_cast<int32_t>(q >> (Q - Fixed::FRACTION_BITS))); }
+
+		constexpr int64_t Q_PI = ToQ(3.14159265358979323846);
+		constexpr int64_t Q_HALF_PI = ToQ(1.57079632679489661923);
+		constexpr int64_t Q_TWO_PI = ToQ(6.28318530717958647692);
+		constexpr int64_t Q_LN2 = ToQ(0.69314718055994530942);
+
+		constexpr uint64_t Isqrt(uint64_t v) {
+			uint64_t result = 0;
+			uint64_t bit = uint64_t(1) << 62;
+			while (bit > v) bit >>= 2;
+			while (bit != 0) {
+				if (v >= result + bit) {
+					v -= result + bit;
+					result = (result >> 1) + bit;
+				}
+				else {
+					result >>= 1;
+				}
+				bit >>= 2;
+			}
+			return result;
+		}
+	}
+
+	constexpr Fixed Abs(Fixed v) noexcept { return v.raw < 0 ? -v : v; }
+	constexpr Fixed Min(Fixed a, Fixed b) noexcept { return a < b ? a : b; }
+	constexpr Fixed Max(Fixed a, Fixed b) noexcept { return a > b ? a : b; }
+	constexpr Fixed Clamp(Fixed v, Fixed min, Fixed max) noexcept { return v < min ? min : v > max ? max : v; }
+	// same sign convention as std::fmod
+	constexpr Fixed Fmod(Fixed a, Fixed b) noexcept { return Fixed::FromRaw(a.raw % b.raw); }
+
+	// Sqrt, Sin, Cos, Atan2 and Log stay within two Q16.16 steps (3e-5) of libm
+	constexpr Fixed Sqrt(Fixed v) noexcept {
+		if (v.raw <= 0) return Fixed();
+		return Fixed::FromRaw(static_cast<int32_t>(Detail::Isqrt(uint64_t(v.raw) << Fixed::FRACTION_BITS)));
+	}
+
+	// Taylor series up to x^9 after reducing to [-PI/2, PI/2]
+	constexpr Fixed Sin(Fixed v) noexcept {
+		using namespace Detail;
+		int64_t x = FromFixed(v) % Q_TWO_PI;
+		if (x > Q_PI) x -= Q_TWO_PI;
+		else if (x < -Q_PI) x += Q_TWO_PI;
+		if (x > Q_HALF_PI) x = Q_PI - x;
+		else if (x < -Q_HALF_PI) x = -Q_PI - x;
+
+		const int64_t x2 = MulQ(x, x);
+		int64_t s = ToQ(1.0 / 362880.0);
+		s = MulQ(s, x2) - ToQ(1.0 / 5040.0);
+		s = MulQ(s, x2) + ToQ(1.0 / 120.0);
+		s = MulQ(s, x2) - ToQ(1.0 / 6.0);
+		s = MulQ(s, x2) + ToQ(1.0);
+		return ToFixed(MulQ(s, x));
+	}
+	constexpr Fixed Cos(Fixed v) noexcept { return Sin(Fixed::FromRaw(v.raw + static_cast<int32_t>(Detail::Q_HALF_PI >> (Detail::Q - Fixed::FRACTION_BITS)))); }
+
+	// Minimax polynomial on [0, 1] plus octant folding
+	constexpr Fixed Atan2(Fixed y, Fixed x) noexcept {
+		using namespace Detail;
+		if (x.raw == 0 && y.raw == 0) return Fixed();
+		const int64_t ax = x.raw < 0 ? -int64_t(x.raw) : x.raw;
+		const int64_t ay = y.raw < 0 ? -int64_t(y.raw) : y.raw;
+		const int64_t t = ((ax < ay ? ax : ay) << Q) / (ax < ay ? ay : ax);
+		const int64_t t2 = MulQ(t, t);
+
+		int64_t a = ToQ(-0.01172120);
+		a = MulQ(a, t2) + ToQ(0.05265332);
+		a = MulQ(a, t2) - ToQ(0.11643287);
+		a = MulQ(a, t2) + ToQ(0.19354346);
+		a = MulQ(a, t2) - ToQ(0.33262347);
+		a = MulQ(a, t2) + ToQ(0.99997726);
+		a = MulQ(a, t);
+
+		if (ay > ax) a = Q_HALF_PI - a;
+		if (x.raw < 0) a = Q_PI - a;
+		if (y.raw < 0) a = -a;
+		return ToFixed(a);
+	}
+
+	// ln(m * 2^e) = e * ln2 + 2 * atanh((m - 1) / (m + 1)). Non-positive input returns the lowest value.
+	constexpr Fixed Log(Fixed v) noexcept {
+		using namespace Detail;
+		if (v.raw <= 0) return Fixed::FromRaw(INT32_MIN);
+		const int msb = std::bit_width(static_cast<uint32_t>(v.raw)) - 1;
+		const int exponent = msb - Fixed::FRACTION_BITS;
+		const int64_t m = msb <= Q ? int64_t(v.raw) << (Q - msb) : int64_t(v.raw) >> (msb - Q); // [1, 2)
+		const int64_t one = int64_t(1) << Q;
+		const int64_t s = ((m - one) << Q) / (m + one);
+		const int64_t s2 = MulQ(s, s);
+
+		int64_t series = ToQ(1.0 / 9.0);
+		series = MulQ(series, s2) + ToQ(1.0 / 7.0);
+		series = MulQ(series, s2) + ToQ(1.0 / 5.0);
+		series = MulQ(series, s2) + ToQ(1.0 / 3.0);
+		series = MulQ(series, s2) + one;
+		return ToFixed(exponent * Q_LN2 + 2 * MulQ(series, s));
+	}
+}
+
+/***********************************************************************
+***************************** Simulation ******************************
+***********************************************************************/
+
+// State of one car that has to match between machines. Templated on the scalar so the same code
+// runs on float (default) and on Fixed (MATH_DETERMINISTIC).
+template <typename Scalar>
+struct CarState {
+	Scalar x{}, z{}, theta{}, velocity{};
+
+	// Car::Update, move along the forward vector (-sin, 0, -cos)
+	constexpr void Advance() {
+		x -= velocity * Math::Sin(theta);
+		z -= velocity * Math::Cos(theta);
+	}
+
+	constexpr void Accelerate(Scalar amount) { velocity += amount; }
+	constexpr void Turn(Scalar amount) { theta += amount; }
+
+	// Mouse steering of Engine::OnEvent: turn towards the target and speed up with the log distance
+	constexpr void SteerTowards(Scalar targetX, Scalar targetZ) {
+		const Scalar pi = Scalar(Math::PI), twoPi = Scalar(Math::TWO_PI), rate = Scalar(0.05f);
+		const Scalar dx = targetX - x, dz = targetZ - z;
+		const Scalar dis = Math::Sqrt(dx * dx + dz * dz);
+		const Scalar angle = Math::Atan2(-dx, -dz);
+
+		const Scalar delta = angle - theta;
+		if (delta > -pi && delta < pi) {
+			theta += delta * rate;
+		}
+		else if (delta < -pi) {
+			theta += (twoPi + delta) * rate;
+		}
+		else if (delta > pi) {
+			theta += (delta - twoPi) * rate;
+		}
+		theta = Math::Fmod(theta, twoPi);
+
+		const Scalar speed = Math::Clamp(Math::Log(dis), Scalar(0), Scalar(1)) * Scalar(0.1f);
+		velocity += (speed - velocity) * Scalar(0.1f);
+	}
+
+	// FNV-1a over the raw state, comparable across machines when Scalar is Fixed
+	constexpr uint64_t Hash(uint64_t hash = 0xcbf29ce484222325ull) const {
+		for (const Scalar& v : { x, z, theta, velocity }) {
+			uint32_t bits = 0;
+			if constexpr (std::is_same_v<Scalar, Fixed>) bits = static_cast<uint32_t>(v.raw);
+			else bits = std::bit_cast<uint32_t>(v);
+			for (int i = 0; i < 4; ++i) {
+				hash ^= (bits >> (8 * i)) & 0xff;
+				hash *= 0x100000001b3ull;
+			}
+		}
+		return hash;
+	}
+};
+
+#if defined(MATH_DETERMINISTIC)
+using SimScalar = Fixed;
+#else
+using SimScalar = float;
+#endif
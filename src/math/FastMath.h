@@ -0,0 +1,226 @@
+#pragma once
+#include "math/Simd.h"
+#include <cassert>
+#include <cfloat>
+#include <span>
+
+// Polynomial approximations of the transcendental functions for hot per-entity code. Every function
+// is one kernel templated on the lane type, so it runs on float, Simd::Float4 and (with AVX2)
+// Simd::Float8, and Math::FastSin gives the same value as lane i of the batch version.
+//
+// Max error against libm (double) over the valid range, checked by bench_math (FMA contraction
+// can move the last bit, hence the margin):
+//   FastSinCos  |x| <= 8192            1.0e-7 absolute
+//   FastAtan2   any finite y, x        2.5e-6 radians
+//   FastExp     [-87.3, 88.3]          1.0e-7 relative
+//   FastLog     [FLT_MIN, FLT_MAX]     1.0e-7 absolute for |log(x)| < 1, relative above
+// Outside of that (inf, NaN, denormals, huge angles) the results are unspecified, use Math::Sin etc.
+// Only depends on Simd.h, so math/Math.inl can use it for Math::ComposeTRS.
+
+namespace Simd {
+	// -- Plain float lanes, so the kernels below also give the constexpr scalar functions --
+	constexpr float Add(float a, float b) { return a + b; }
+	constexpr float Sub(float a, float b) { return a - b; }
+	constexpr float Mul(float a, float b) { return a * b; }
+	constexpr float Div(float a, float b) { return a / b; }
+	constexpr float Min(float a, float b) { return a < b ? a : b; }
+	constexpr float Max(float a, float b) { return a > b ? a : b; }
+	constexpr uint32_t Add(uint32_t a, uint32_t b) { return a + b; }
+	constexpr uint32_t Sub(uint32_t a, uint32_t b) { return a - b; }
+	constexpr uint32_t And(uint32_t a, uint32_t b) { return a & b; }
+	constexpr uint32_t Xor(uint32_t a, uint32_t b) { return a ^ b; }
+	template <int N>
+	constexpr uint32_t ShiftLeft(uint32_t v) { return v << N; }
+	template <int N>
+	constexpr uint32_t ShiftRight(uint32_t v) { return v >> N; }
+	// nearest, ties to even like the SIMD versions: adding 1.5 * 2^23 pushes the fraction out of the mantissa (|v| < 2^22)
+	constexpr uint32_t RoundToInt(float v) { return uint32_t(int32_t((v + 12582912.0f) - 12582912.0f)); }
+	constexpr float ToFloat(uint32_t v) { return float(int32_t(v)); }
+	constexpr uint32_t AsUInt(float v) { return std::bit_cast<uint32_t>(v); }
+	constexpr float AsFloat(uint32_t v) { return std::bit_cast<float>(v); }
+
+	// Splat and unaligned load for a lane type picked by template argument
+	template <typename F> F SplatAs(float s);
+	template <> constexpr float SplatAs<float>(float s) { return s; }
+	template <> inline Float4 SplatAs<Float4>(float s) { return Splat(s); }
+	template <typename I> I SplatUIntAs(uint32_t s);
+	template <> constexpr uint32_t SplatUIntAs<uint32_t>(uint32_t s) { return s; }
+	template <> inline UInt4 SplatUIntAs<UInt4>(uint32_t s) { return SplatUInt(s); }
+	template <typename F> F LoadAs(const float* p);
+	template <> constexpr float LoadAs<float>(const float* p) { return *p; }
+	template <> inline Float4 LoadAs<Float4>(const float* p) { return LoadUnaligned(p); }
+	constexpr void StoreUnaligned(float* p, float v) { *p = v; }
+#if defined(MATH_SIMD_WIDE8)
+	template <> inline Float8 SplatAs<Float8>(float s) { return Splat8(s); }
+	template <> inline UInt8 SplatUIntAs<UInt8>(uint32_t s) { return SplatUInt8(s); }
+	template <> inline Float8 LoadAs<Float8>(const float* p) { return LoadUnaligned8(p); }
+#endif
+
+	// Calls fn(F{}, i) for the widest lane type F that still fits, the tail runs on plain floats
+	template <typename Fn>
+	inline void ForEachLanes(size_t count, Fn&& fn) {
+		size_t i = 0;
+#if defined(MATH_SIMD_WIDE8)
+		for (; i + 8 <= count; i += 8) fn(Float8{}, i);
+#endif
+		for (; i + 4 <= count; i += 4) fn(Float4{}, i);
+		for (; i < count; ++i) fn(0.0f, i);
+	}
+
+	/*********************************************************************
+	**************************** Transcendental **************************
+	**********************************************************************/
+
+	// a where mask is all ones, b where it is zero
+	template <typename F, typename I>
+	constexpr F Select(I mask, F a, F b) { return AsFloat(Xor(AsUInt(b), And(Xor(AsUInt(a), AsUInt(b)), mask))); }
+
+	template <typename F>
+	constexpr void SinCos(F x, F& s, F& c) {
+		using I = decltype(AsUInt(x));
+		const I q = RoundToInt(Mul(x, SplatAs<F>(0.636619772f))); // x * 2 / PI
+		const F qf = ToFloat(q);
+		// PI / 2 in three parts (Cody-Waite) so the reduction stays exact for large q
+		F r = Sub(x, Mul(qf, SplatAs<F>(1.5703125f)));
+		r = Sub(r, Mul(qf, SplatAs<F>(4.837512969970703125e-4f)));
+		r = Sub(r, Mul(qf, SplatAs<F>(7.54978995489188216e-8f)));
+		const F r2 = Mul(r, r);
+
+		// minimax polynomials on [-PI/4, PI/4] from Cephes sinf/cosf
+		F ps = Add(Mul(SplatAs<F>(-1.9515295891e-4f), r2), SplatAs<F>(8.3321608736e-3f));
+		ps = Add(Mul(ps, r2), SplatAs<F>(-1.6666654611e-1f));
+		ps = Add(Mul(Mul(ps, r2), r), r);
+		F pc = Add(Mul(SplatAs<F>(2.443315711809948e-5f), r2), SplatAs<F>(-1.388731625493765e-3f));
+		pc = Add(Mul(pc, r2), SplatAs<F>(4.166664568298827e-2f));
+		pc = Add(Sub(Mul(Mul(pc, r2), r2), Mul(r2, SplatAs<F>(0.5f))), SplatAs<F>(1.0f));
+
+		// odd quadrants swap sin and cos, the signs come from bit 1 of q and q + 1
+		const I one = SplatUIntAs<I>(1), two = SplatUIntAs<I>(2);
+		const I swap = Sub(SplatUIntAs<I>(0), And(q, one));
+		s = AsFloat(Xor(AsUInt(Select(swap, pc, ps)), ShiftLeft<30>(And(q, two))));
+		c = AsFloat(Xor(AsUInt(Select(swap, ps, pc)), ShiftLeft<30>(And(Add(q, one), two))));
+	}
+
+	template <typename F>
+	constexpr F Atan2(F y, F x) {
+		using I = decltype(AsUInt(x));
+		const I signBit = SplatUIntAs<I>(0x80000000u), zero = SplatUIntAs<I>(0);
+		const I xSign = And(AsUInt(x), signBit), ySign = And(AsUInt(y), signBit);
+		const F ax = AsFloat(Xor(AsUInt(x), xSign)), ay = AsFloat(Xor(AsUInt(y), ySign));
+
+		// atan on [0, 1], the FLT_MIN keeps atan2(0, 0) finite (0 or PI like libm)
+		const F t = Div(Min(ax, ay), Max(Max(ax, ay), SplatAs<F>(FLT_MIN)));
+		const F t2 = Mul(t, t);
+		F a = Add(Mul(SplatAs<F>(-0.01172120f), t2), SplatAs<F>(0.05265332f));
+		a = Add(Mul(a, t2), SplatAs<F>(-0.11643287f));
+		a = Add(Mul(a, t2), SplatAs<F>(0.19354346f));
+		a = Add(Mul(a, t2), SplatAs<F>(-0.33262347f));
+		a = Add(Mul(a, t2), SplatAs<F>(0.99997726f));
+		a = Mul(a, t);
+
+		// the sign bit of ax - ay tells whether the octant has to be mirrored
+		const I steep = Sub(zero, ShiftRight<31>(AsUInt(Sub(ax, ay))));
+		a = Select(steep, Sub(SplatAs<F>(1.57079632679489661923f), a), a);
+		a = Select(Sub(zero, ShiftRight<31>(xSign)), Sub(SplatAs<F>(3.14159265358979323846f), a), a);
+		return AsFloat(Xor(AsUInt(a), ySign));
+	}
+
+	template <typename F>
+	constexpr F Exp(F x) {
+		using I = decltype(AsUInt(x));
+		// keeps 2^n a normal float
+		x = Min(Max(x, SplatAs<F>(-87.3f)), SplatAs<F>(88.3f));
+		const I n = RoundToInt(Mul(x, SplatAs<F>(1.44269504088896341f)));
+		const F nf = ToFloat(n);
+		// ln2 in two parts
+		F r = Sub(x, Mul(nf, SplatAs<F>(0.693359375f)));
+		r = Sub(r, Mul(nf, SplatAs<F>(-2.12194440e-4f)));
+
+		// Cephes expf on [-ln2 / 2, ln2 / 2]
+		F p = Add(Mul(SplatAs<F>(1.9875691500e-4f), r), SplatAs<F>(1.3981999507e-3f));
+		p = Add(Mul(p, r), SplatAs<F>(8.3334519073e-3f));
+		p = Add(Mul(p, r), SplatAs<F>(4.1665795894e-2f));
+		p = Add(Mul(p, r), SplatAs<F>(1.6666665459e-1f));
+		p = Add(Mul(p, r), SplatAs<F>(5.0000001201e-1f));
+		p = Add(Add(Mul(Mul(p, r), r), r), SplatAs<F>(1.0f));
+
+		return Mul(p, AsFloat(ShiftLeft<23>(Add(n, SplatUIntAs<I>(127)))));
+	}
+
+	template <typename F>
+	constexpr F Log(F x) {
+		using I = decltype(AsUInt(x));
+		// x = m * 2^k with m in [sqrt(1/2), sqrt(2)), done on the bits like musl's logf
+		I bits = Add(AsUInt(x), SplatUIntAs<I>(0x3f800000u - 0x3f3504f3u));
+		const F k = Sub(ToFloat(ShiftRight<23>(bits)), SplatAs<F>(127.0f));
+		bits = Add(And(bits, SplatUIntAs<I>(0x007fffffu)), SplatUIntAs<I>(0x3f3504f3u));
+		const F f = Sub(AsFloat(bits), SplatAs<F>(1.0f));
+		const F f2 = Mul(f, f);
+
+		// Cephes logf, log(1 + f) = f - f^2 / 2 + f^3 * P(f)
+		F p = Add(Mul(SplatAs<F>(7.0376836292e-2f), f), SplatAs<F>(-1.1514610310e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(1.1676998740e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(-1.2420140846e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(1.4249322787e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(-1.6668057665e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(2.0000714765e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(-2.4999993993e-1f));
+		p = Add(Mul(p, f), SplatAs<F>(3.3333331174e-1f));
+		p = Mul(Mul(p, f), f2);
+
+		// ln2 in two parts again
+		p = Add(p, Mul(k, SplatAs<F>(-2.12194440e-4f)));
+		p = Sub(p, Mul(f2, SplatAs<F>(0.5f)));
+		return Add(Add(f, p), Mul(k, SplatAs<F>(0.693359375f)));
+	}
+}
+
+namespace Math {
+	constexpr void FastSinCos(float x, float& s, float& c) noexcept { Simd::SinCos(x, s, c); }
+	constexpr float FastSin(float x) noexcept {
+		float s = 0, c = 0;
+		Simd::SinCos(x, s, c);
+		return s;
+	}
+	constexpr float FastCos(float x) noexcept {
+		float s = 0, c = 0;
+		Simd::SinCos(x, s, c);
+		return c;
+	}
+	constexpr float FastAtan2(float y, float x) noexcept { return Simd::Atan2(y, x); }
+	constexpr float FastExp(float x) noexcept { return Simd::Exp(x); }
+	constexpr float FastLog(float x) noexcept { return Simd::Log(x); }
+
+	// Batch versions, 8 (AVX2) or 4 lanes per iteration. All spans must have the same size.
+	inline void FastSinCos(std::span<const float> x, std::span<float> s, std::span<float> c) noexcept {
+		assert(s.size() == x.size() && c.size() == x.size());
+		Simd::ForEachLanes(x.size(), [&](auto lane, size_t i) {
+			using F = decltype(lane);
+			F sinX, cosX;
+			Simd::SinCos(Simd::LoadAs<F>(&x[i]), sinX, cosX);
+			Simd::StoreUnaligned(&s[i], sinX);
+			Simd::StoreUnaligned(&c[i], cosX);
+		});
+	}
+	inline void FastAtan2(std::span<const float> y, std::span<const float> x, std::span<float> out) noexcept {
+		assert(y.size() == out.size() && x.size() == out.size());
+		Simd::ForEachLanes(out.size(), [&](auto lane, size_t i) {
+			using F = decltype(lane);
+			Simd::StoreUnaligned(&out[i], Simd::Atan2(Simd::LoadAs<F>(&y[i]), Simd::LoadAs<F>(&x[i])));
+		});
+	}
+	inline void FastExp(std::span<const float> x, std::span<float> out) noexcept {
+		assert(x.size() == out.size());
+		Simd::ForEachLanes(out.size(), [&](auto lane, size_t i) {
+			using F = decltype(lane);
+			Simd::StoreUnaligned(&out[i], Simd::Exp(Simd::LoadAs<F>(&x[i])));
+		});
+	}
+	inline void FastLog(std::span<const float> x, std::span<float> out) noexcept {
+		assert(x.size() == out.size());
+		Simd::ForEachLanes(out.size(), [&](auto lane, size_t i) {
+			using F = decltype(lane);
+			Simd::StoreUnaligned(&out[i], Simd::Log(Simd::LoadAs<F>(&x[i])));
+		});
+	}
+}
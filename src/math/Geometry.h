@@ -0,0 +1,284 @@
+#pragma once
+#include "math/Matrix.h"
+#include "math/Simd.h"
+
+// Bounding volumes and rays for culling, picking and collision on the CPU. The single-primitive
+// tests are constexpr, the span versions run four primitives per SIMD iteration.
+
+/***********************************************************************
+******************************** AABB *********************************
+***********************************************************************/
+
+struct AABB {
+	Vector3 min = Vector3(Math::POS_INFINITY);
+	Vector3 max = Vector3(Math::NEG_INFINITY);
+
+	constexpr AABB() noexcept = default;
+	constexpr AABB(const Vector3& min, const Vector3& max) noexcept : min(min), max(max) {}
+
+	// an empty box has min > max, merging anything into it gives that thing
+	constexpr bool IsEmpty() const noexcept { return min.x > max.x || min.y > max.y || min.z > max.z; }
+	constexpr Vector3 Center() const noexcept { return (min + max) * 0.5f; }
+	constexpr Vector3 Extent() const noexcept { return (max - min) * 0.5f; }
+
+	constexpr void Merge(const Vector3& p) noexcept {
+		min = Math::Min(min, p);
+		max = Math::Max(max, p);
+	}
+	constexpr void Merge(const AABB& box) noexcept {
+		min = Math::Min(min, box.min);
+		max = Math::Max(max, box.max);
+	}
+	constexpr bool Contains(const Vector3& p) const noexcept {
+		return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+	}
+};
+
+/***********************************************************************
+******************************** Sphere *******************************
+***********************************************************************/
+
+struct Sphere {
+	Vector3 center = Vector3::ZERO;
+	float radius = 0.0f;
+
+	constexpr Sphere() noexcept = default;
+	constexpr Sphere(const Vector3& center, float radius) noexcept : center(center), radius(radius) {}
+
+	constexpr bool Contains(const Vector3& p) const noexcept { return Math::Dot(p - center, p - center) <= radius * radius; }
+};
+
+/***********************************************************************
+******************************** Plane ********************************
+***********************************************************************/
+
+// Points with Dot(normal, p) + d >= 0 are on the positive side
+struct Plane {
+	Vector3 normal = Vector3(0, 1, 0);
+	float d = 0.0f;
+
+	constexpr Plane() noexcept = default;
+	constexpr Plane(const Vector3& normal, float d) noexcept : normal(normal), d(d) {}
+	constexpr Plane(const Vector3& normal, const Vector3& point) noexcept : normal(normal), d(-Math::Dot(normal, point)) {}
+	constexpr explicit Plane(const Vector4& v) noexcept : normal(v.x, v.y, v.z), d(v.w) {}
+
+	// signed distance, only metric when the normal has unit length
+	constexpr float Distance(const Vector3& p) const noexcept { return Math::Dot(normal, p) + d; }
+};
+
+/***********************************************************************
+******************************* Frustum *******************************
+***********************************************************************/
+
+class Frustum {
+public:
+	enum Side { Left, Right, Bottom, Top, Near, Far, Count };
+
+	// One (nx, ny, nz, d) row per side, normals point inside and have unit length
+	alignas(16) float planes[Count][4] = {};
+
+public:
+	constexpr Frustum() noexcept = default;
+	// Gribb/Hartmann extraction from an OpenGL (-1..1 depth) projection * view, e.g. Camera::GetViewProjection()
+	inline explicit Frustum(const Matrix4& viewProjection) noexcept;
+
+	constexpr Plane GetPlane(Side side) const noexcept { return Plane(Vector3(planes[side][0], planes[side][1], planes[side][2]), planes[side][3]); }
+};
+
+/***********************************************************************
+********************************* Ray *********************************
+***********************************************************************/
+
+struct Ray {
+	Vector3 origin = Vector3::ZERO;
+	Vector3 direction = Vector3(0, 0, -1);
+
+	constexpr Ray() noexcept = default;
+	constexpr Ray(const Vector3& origin, const Vector3& direction) noexcept : origin(origin), direction(direction) {}
+
+	constexpr Vector3 At(float t) const noexcept { return origin + direction * t; }
+};
+
+namespace Math {
+	/*********************************************************************
+	******************************* Geometry *****************************
+	**********************************************************************/
+
+	// Arvo's method: the box that encloses the transformed box
+	constexpr AABB Transform(const AABB& box, const Matrix4& m) noexcept {
+		if (box.IsEmpty()) return box;
+		const Vector3 center = box.Center(), extent = box.Extent();
+		const Vector3 c = Vector3(m[0]) * center.x + Vector3(m[1]) * center.y + Vector3(m[2]) * center.z + Vector3(m[3]);
+		const Vector3 e = Abs(Vector3(m[0])) * extent.x + Abs(Vector3(m[1])) * extent.y + Abs(Vector3(m[2])) * extent.z;
+		return AABB(c - e, c + e);
+	}
+
+	constexpr bool Intersects(const AABB& a, const AABB& b) noexcept {
+		return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+	}
+	constexpr bool Intersects(const Sphere& a, const Sphere& b) noexcept {
+		const float r = a.radius + b.radius;
+		return Dot(a.center - b.center, a.center - b.center) <= r * r;
+	}
+	constexpr bool Intersects(const AABB& box, const Sphere& sphere) noexcept {
+		const Vector3 closest = Min(Max(sphere.center, box.min), box.max);
+		return sphere.Contains(closest);
+	}
+
+	// false when the box is completely outside one of the planes. Conservative: boxes near a corner
+	// of the frustum may pass although they are outside.
+	constexpr bool Intersects(const Frustum& frustum, const AABB& box) noexcept {
+		const Vector3 center = box.Center(), extent = box.Extent();
+		for (int i = 0; i < Frustum::Count; ++i) {
+			const Plane plane = frustum.GetPlane(Frustum::Side(i));
+			if (plane.Distance(center) + Dot(Abs(plane.normal), extent) < 0.0f) return false;
+		}
+		return true;
+	}
+	constexpr bool Intersects(const Frustum& frustum, const Sphere& sphere) noexcept {
+		for (int i = 0; i < Frustum::Count; ++i) {
+			if (frustum.GetPlane(Frustum::Side(i)).Distance(sphere.center) < -sphere.radius) return false;
+		}
+		return true;
+	}
+
+	// Slab test, t is the entry distance in units of ray.direction (0 when the origin is inside)
+	constexpr bool Intersects(const Ray& ray, const AABB& box, float& t, float tMax = POS_INFINITY) noexcept {
+		float enter = 0.0f, exit = tMax;
+		for (int i = 0; i < 3; ++i) {
+			const float inv = 1.0f / ray.direction[i];
+			float t0 = (box.min[i] - ray.origin[i]) * inv;
+			float t1 = (box.max[i] - ray.origin[i]) * inv;
+			if (t0 > t1) std::swap(t0, t1);
+			enter = Max(enter, t0);
+			exit = Min(exit, t1);
+		}
+		t = enter;
+		return enter <= exit;
+	}
+
+	// Moller-Trumbore, both faces count
+	constexpr bool Intersects(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& t) noexcept {
+		const Vector3 e1 = v1 - v0, e2 = v2 - v0;
+		const Vector3 p = Cross(ray.direction, e2);
+		const float det = Dot(e1, p);
+		if (Abs(det) <= 1e-7f) return false;
+		const float invDet = 1.0f / det;
+		const Vector3 s = ray.origin - v0;
+		const float u = Dot(s, p) * invDet;
+		if (u < 0.0f || u > 1.0f) return false;
+		const Vector3 q = Cross(s, e1);
+		const float v = Dot(ray.direction, q) * invDet;
+		if (v < 0.0f || u + v > 1.0f) return false;
+		t = Dot(e2, q) * invDet;
+		return t > 1e-7f;
+	}
+
+	// Writes 1 to visible[i] when boxes[i] passes Intersects(frustum, boxes[i]), 0 otherwise, and
+	// returns the number of visible boxes. Both spans must have the same size.
+	inline size_t Cull(const Frustum& frustum, std::span<const AABB> boxes, std::span<uint8_t> visible) noexcept;
+	// Index of the closest box hit by the ray within tMax, or -1. t receives the entry distance.
+	inline int Raycast(const Ray& ray, std::span<const AABB> boxes, float& t, float tMax = POS_INFINITY) noexcept;
+	// Same for a triangle list, three consecutive vertices per triangle. Returns the triangle index.
+	inline int Raycast(const Ray& ray, std::span<const Vector3> triangles, float& t, float tMax = POS_INFINITY) noexcept;
+}
+
+/***********************************************************************
+**************************** Implementation ***************************
+***********************************************************************/
+
+inline Frustum::Frustum(const Matrix4& m) noexcept {
+	// rows of the column-major matrix
+	const Vector4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	const Vector4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	const Vector4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	const Vector4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+	const Vector4 sides[Count] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+	for (int i = 0; i < Count; ++i) {
+		const Vector4 plane = sides[i] / Math::Length(Vector3(sides[i]));
+		planes[i][0] = plane.x;
+		planes[i][1] = plane.y;
+		planes[i][2] = plane.z;
+		planes[i][3] = plane.w;
+	}
+}
+
+namespace Math {
+	inline size_t Cull(const Frustum& frustum, std::span<const AABB> boxes, std::span<uint8_t> visible) noexcept {
+		assert(boxes.size() == visible.size());
+
+		const size_t count = boxes.size();
+		size_t visibleCount = 0;
+		for (size_t i = 0; i < count; i += 4) {
+			// the last group repeats its final box in the unused lanes
+			alignas(16) float lanes[6][4];
+			for (int j = 0; j < 4; ++j) {
+				const AABB& box = boxes[std::min(i + j, count - 1)];
+				const Vector3 center = box.Center(), extent = box.Extent();
+				lanes[0][j] = center.x; lanes[1][j] = center.y; lanes[2][j] = center.z;
+				lanes[3][j] = extent.x; lanes[4][j] = extent.y; lanes[5][j] = extent.z;
+			}
+			const int outside = Simd::FrustumOutsideAABB4(&frustum.planes[0][0], Simd::Load(lanes[0]), Simd::Load(lanes[1]), Simd::Load(lanes[2]),
+				Simd::Load(lanes[3]), Simd::Load(lanes[4]), Simd::Load(lanes[5]));
+			for (size_t j = 0; j < 4 && i + j < count; ++j) {
+				visible[i + j] = (outside >> j & 1) ? 0 : 1;
+				visibleCount += visible[i + j];
+			}
+		}
+		return visibleCount;
+	}
+
+	inline int Raycast(const Ray& ray, std::span<const AABB> boxes, float& t, float tMax) noexcept {
+		const Vector3 invDirection = 1.0f / ray.direction;
+		const size_t count = boxes.size();
+		int closest = -1;
+		for (size_t i = 0; i < count; i += 4) {
+			const AABB& b0 = boxes[i];
+			const AABB& b1 = boxes[std::min(i + 1, count - 1)];
+			const AABB& b2 = boxes[std::min(i + 2, count - 1)];
+			const AABB& b3 = boxes[std::min(i + 3, count - 1)];
+			alignas(16) float tNear[4];
+			const int hit = Simd::RayAABB4(Ptr(ray.origin), Ptr(invDirection), tMax,
+				Simd::Set(b0.min.x, b1.min.x, b2.min.x, b3.min.x), Simd::Set(b0.min.y, b1.min.y, b2.min.y, b3.min.y), Simd::Set(b0.min.z, b1.min.z, b2.min.z, b3.min.z),
+				Simd::Set(b0.max.x, b1.max.x, b2.max.x, b3.max.x), Simd::Set(b0.max.y, b1.max.y, b2.max.y, b3.max.y), Simd::Set(b0.max.z, b1.max.z, b2.max.z, b3.max.z), tNear);
+			if (hit == 0) continue;
+			for (size_t j = 0; j < 4 && i + j < count; ++j) {
+				if ((hit >> j & 1) && tNear[j] < tMax) {
+					tMax = tNear[j];
+					closest = static_cast<int>(i + j);
+				}
+			}
+		}
+		if (closest >= 0) t = tMax;
+		return closest;
+	}
+
+	inline int Raycast(const Ray& ray, std::span<const Vector3> triangles, float& t, float tMax) noexcept {
+		assert(triangles.size() % 3 == 0);
+
+		const size_t count = triangles.size() / 3;
+		int closest = -1;
+		for (size_t i = 0; i < count; i += 4) {
+			alignas(16) float lanes[9][4];
+			for (int j = 0; j < 4; ++j) {
+				const size_t k = 3 * std::min(i + j, count - 1);
+				const Vector3& v0 = triangles[k];
+				const Vector3 e1 = triangles[k + 1] - v0, e2 = triangles[k + 2] - v0;
+				lanes[0][j] = v0.x; lanes[1][j] = v0.y; lanes[2][j] = v0.z;
+				lanes[3][j] = e1.x; lanes[4][j] = e1.y; lanes[5][j] = e1.z;
+				lanes[6][j] = e2.x; lanes[7][j] = e2.y; lanes[8][j] = e2.z;
+			}
+			alignas(16) float distance[4];
+			const int hit = Simd::RayTriangle4(Ptr(ray.origin), Ptr(ray.direction), Simd::Load(lanes[0]), Simd::Load(lanes[1]), Simd::Load(lanes[2]),
+				Simd::Load(lanes[3]), Simd::Load(lanes[4]), Simd::Load(lanes[5]), Simd::Load(lanes[6]), Simd::Load(lanes[7]), Simd::Load(lanes[8]), distance);
+			for (size_t j = 0; j < 4 && i + j < count; ++j) {
+				if ((hit >> j & 1) && distance[j] < tMax) {
+					tMax = distance[j];
+					closest = static_cast<int>(i + j);
+				}
+			}
+		}
+		if (closest >= 0) t = tMax;
+		return closest;
+	}
+}
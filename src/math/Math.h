@@ -1,138 +1,186 @@
 #pragma once
 #include "Defines.h"
+#include "math/Vector.h"
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
 #include <limits>
+#include <span>
 
-class Vector2;
-class Vector3;
-class Vector4;
 class Matrix3;
 class Matrix4;
 class Quaternion;
 
+// The math library is header-only: everything is inline so the per-frame code in
+// Engine, Camera and Transform can be inlined without LTO, and the vector/matrix
+// helpers are constexpr wherever the standard library allows it.
 namespace Math {
-	static const float POS_INFINITY = std::numeric_limits<float>::infinity();
-	static const float NEG_INFINITY = -std::numeric_limits<float>::infinity();
-	static const float PI = 3.14159265358979323846264338327950288f;
-	static const float ONE_OVER_PI = 1.0f / PI;
-	static const float TWO_PI = 2.0f * PI;
-	static const float HALF_PI = 0.5f * PI;
-	static const float fDeg2Rad = PI / 180.0f;
-	static const float fRad2Deg = 180.0f / PI;
-	static const float LOG2 = log(2.0f);
-	static const float EPSILON = 1e-6f;
-
-	static const float EPSILONF = FLT_EPSILON;
-	static const float EPSILOND = DBL_EPSILON;
-
-	float Radians(float degrees);
-	Vector3 Radians(const Vector3& degrees);
-	float Degrees(float radians);
-	Vector3 Degrees(const Vector3& radians);
-
-	float* Ptr(Vector2& v);
-	const float* Ptr(const Vector2& v);
-	float* Ptr(Vector3& v);
-	const float* Ptr(const Vector3& v);
-	float* Ptr(Vector4& v);
-	const float* Ptr(const Vector4& v);
-	float* Ptr(Matrix3& v);
-	const float* Ptr(const Matrix3& v);
-	float* Ptr(Matrix4& v);
-	const float* Ptr(const Matrix4& v);
-
-	float Sin(float v);
-	Vector2 Sin(const Vector2& v);
-	Vector3 Sin(const Vector3& v);
-	Vector4 Sin(const Vector4& v);
-	float Cos(float v);
-	Vector2 Cos(const Vector2& v);
-	Vector3 Cos(const Vector3& v);
-	Vector4 Cos(const Vector4& v);
-	float Tan(float v);
-	Vector2 Tan(const Vector2& v);
-	Vector3 Tan(const Vector3& v);
-	Vector4 Tan(const Vector4& v);
-
-	float Min(float a, float b);
-
-	float Max(float a, float b);
-
-	bool EpsilonEqual(float a, float b, float epsilon = EPSILONF);
-	bool EpsilonEqual(const Vector2& a, const Vector2& b, float epsilon = EPSILONF);
-
-	float Clamp(float v, float min, float max);
+	inline constexpr float POS_INFINITY = std::numeric_limits<float>::infinity();
+	inline constexpr float NEG_INFINITY = -std::numeric_limits<float>::infinity();
+	inline constexpr float PI = 3.14159265358979323846264338327950288f;
+	inline constexpr float ONE_OVER_PI = 1.0f / PI;
+	inline constexpr float TWO_PI = 2.0f * PI;
+	inline constexpr float HALF_PI = 0.5f * PI;
+	inline constexpr float fDeg2Rad = PI / 180.0f;
+	inline constexpr float fRad2Deg = 180.0f / PI;
+	inline constexpr float LOG2 = 0.693147180559945309417232121458176568f;
+	inline constexpr float EPSILON = 1e-6f;
+
+	inline constexpr float EPSILONF = FLT_EPSILON;
+	inline constexpr float EPSILOND = DBL_EPSILON;
+
+	constexpr float Radians(float degrees) noexcept { return degrees * PI / 180.f; }
+	constexpr Vector3 Radians(const Vector3& degrees) noexcept { return degrees * PI / 180.f; }
+	constexpr float Degrees(float radians) noexcept { return radians * 180.f / PI; }
+	constexpr Vector3 Degrees(const Vector3& radians) noexcept { return radians * 180.f / PI; }
+
+	constexpr float* Ptr(Vector2& v) noexcept { return &v.x; }
+	constexpr const float* Ptr(const Vector2& v) noexcept { return &v.x; }
+	constexpr float* Ptr(Vector3& v) noexcept { return &v.x; }
+	constexpr const float* Ptr(const Vector3& v) noexcept { return &v.x; }
+	constexpr float* Ptr(Vector4& v) noexcept { return &v.x; }
+	constexpr const float* Ptr(const Vector4& v) noexcept { return &v.x; }
+	constexpr float* Ptr(Matrix3& v) noexcept;
+	constexpr const float* Ptr(const Matrix3& v) noexcept;
+	constexpr float* Ptr(Matrix4& v) noexcept;
+	constexpr const float* Ptr(const Matrix4& v) noexcept;
+
+	inline float Sin(float v) noexcept { return sinf(v); }
+	inline Vector2 Sin(const Vector2& v) noexcept { return Vector2(sinf(v.x), sinf(v.y)); }
+	inline Vector3 Sin(const Vector3& v) noexcept { return Vector3(sinf(v.x), sinf(v.y), sinf(v.z)); }
+	inline Vector4 Sin(const Vector4& v) noexcept { return Vector4(sinf(v.x), sinf(v.y), sinf(v.z), sinf(v.w)); }
+	inline float Cos(float v) noexcept { return cosf(v); }
+	inline Vector2 Cos(const Vector2& v) noexcept { return Vector2(cosf(v.x), cosf(v.y)); }
+	inline Vector3 Cos(const Vector3& v) noexcept { return Vector3(cosf(v.x), cosf(v.y), cosf(v.z)); }
+	inline Vector4 Cos(const Vector4& v) noexcept { return Vector4(cosf(v.x), cosf(v.y), cosf(v.z), cosf(v.w)); }
+	inline float Tan(float v) noexcept { return tanf(v); }
+	inline Vector2 Tan(const Vector2& v) noexcept { return Vector2(tanf(v.x), tanf(v.y)); }
+	inline Vector3 Tan(const Vector3& v) noexcept { return Vector3(tanf(v.x), tanf(v.y), tanf(v.z)); }
+	inline Vector4 Tan(const Vector4& v) noexcept { return Vector4(tanf(v.x), tanf(v.y), tanf(v.z), tanf(v.w)); }
+	inline float Atan2(float y, float x) noexcept { return atan2f(y, x); }
+	inline float Sqrt(float v) noexcept { return sqrtf(v); }
+	inline float Log(float v) noexcept { return logf(v); }
+	inline float Fmod(float a, float b) noexcept { return fmodf(a, b); }
+
+	constexpr float Min(float a, float b) noexcept { return a < b ? a : b; }
+
+	constexpr float Max(float a, float b) noexcept { return a > b ? a : b; }
+
+	constexpr float Abs(float v) noexcept { return v < 0.0f ? -v : v; }
+
+	constexpr bool EpsilonEqual(float a, float b, float epsilon = EPSILONF) noexcept { return Abs(a - b) < epsilon; }
+	constexpr bool EpsilonEqual(const Vector2& a, const Vector2& b, float epsilon = EPSILONF) noexcept { return EpsilonEqual(a.x, b.x, epsilon) && EpsilonEqual(a.y, b.y, epsilon); }
+
+	constexpr float Clamp(float v, float min, float max) noexcept { return v < min ? min : v > max ? max : v; }
 
 	/*********************************************************************
 	******************************* Vector *******************************
 	**********************************************************************/
 
-	float Dot(const Vector2& a, const Vector2& b);
-	float Dot(const Vector3& a, const Vector3& b);
-	float Dot(const Vector4& a, const Vector4& b);
-
-	Vector2 Cross(const Vector2& a, const Vector2& b);
-	Vector3 Cross(const Vector3& a, const Vector3& b);
-	Vector4 Cross(const Vector4& a, const Vector4& b);
-
-	Vector2 Normalize(const Vector2& v);
-	Vector3 Normalize(const Vector3& v);
-	Vector4 Normalize(const Vector4& v);
-
-	float Length(const Vector2& v);
-	float Length(const Vector3& v);
-	float Length(const Vector4& v);
-
-	float Mix(const float& a, const float& b, float t);
-	Vector2 Mix(const Vector2& a, const Vector2& b, float t);
-	Vector3 Mix(const Vector3& a, const Vector3& b, float t);
-	Vector4 Mix(const Vector4& a, const Vector4& b, float t);
-
-	Vector2 Scale(const Vector2& v, float length);
-	Vector3 Scale(const Vector3& v, float length);
-	Vector4 Scale(const Vector4& v, float length);
-
-	Vector2 Combine(const Vector2& a, const Vector2& b, float fa, float fb);
-	Vector3 Combine(const Vector3& a, const Vector3& b, float fa, float fb);
-	Vector4 Combine(const Vector4& a, const Vector4& b, float fa, float fb);
+	constexpr float Dot(const Vector2& a, const Vector2& b) noexcept {
+		Vector2 tmp(a * b);
+		return tmp.x + tmp.y;
+	}
+	constexpr float Dot(const Vector3& a, const Vector3& b) noexcept {
+		Vector3 tmp(a * b);
+		return tmp.x + tmp.y + tmp.z;
+	}
+	constexpr float Dot(const Vector4& a, const Vector4& b) noexcept {
+		Vector4 tmp(a * b);
+		return tmp.x + tmp.y + tmp.z + tmp.w;
+	}
+
+	constexpr Vector2 Cross(const Vector2& a, const Vector2& b) noexcept {
+		return { a.x * b.y - a.y * b.x };
+	}
+	constexpr Vector3 Cross(const Vector3& a, const Vector3& b) noexcept {
+		return { a.y * b.z - a.z * b.y,
+			   a.z * b.x - a.x * b.z,
+			   a.x * b.y - a.y * b.x };
+	}
+	constexpr Vector4 Cross(const Vector4& a, const Vector4& b) noexcept {
+		return {
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x,
+			0
+		};
+	}
+
+	constexpr Vector3 Min(const Vector3& a, const Vector3& b) noexcept { return { Min(a.x, b.x), Min(a.y, b.y), Min(a.z, b.z) }; }
+	constexpr Vector3 Max(const Vector3& a, const Vector3& b) noexcept { return { Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z) }; }
+	constexpr Vector3 Abs(const Vector3& v) noexcept { return { Abs(v.x), Abs(v.y), Abs(v.z) }; }
+
+	inline float Length(const Vector2& v) noexcept { return sqrtf(Dot(v, v)); }
+	inline float Length(const Vector3& v) noexcept { return sqrtf(Dot(v, v)); }
+	inline float Length(const Vector4& v) noexcept { return sqrtf(Dot(v, v)); }
+
+	inline Vector2 Normalize(const Vector2& v) noexcept { return v / Length(v); }
+	inline Vector3 Normalize(const Vector3& v) noexcept { return v / Length(v); }
+	inline Vector4 Normalize(const Vector4& v) noexcept { return v / Length(v); }
+
+	constexpr float Mix(const float& a, const float& b, float t) noexcept { return a * (1 - t) + b * t; }
+	constexpr Vector2 Mix(const Vector2& a, const Vector2& b, float t) noexcept { return a * (1 - t) + b * t; }
+	constexpr Vector3 Mix(const Vector3& a, const Vector3& b, float t) noexcept { return a * (1 - t) + b * t; }
+	constexpr Vector4 Mix(const Vector4& a, const Vector4& b, float t) noexcept { return a * (1 - t) + b * t; }
+
+	inline Vector2 Scale(const Vector2& v, float length) noexcept { return Normalize(v) * length; }
+	inline Vector3 Scale(const Vector3& v, float length) noexcept { return Normalize(v) * length; }
+	inline Vector4 Scale(const Vector4& v, float length) noexcept { return Normalize(v) * length; }
+
+	constexpr Vector2 Combine(const Vector2& a, const Vector2& b, float fa, float fb) noexcept { return a * fa + b * fb; }
+	constexpr Vector3 Combine(const Vector3& a, const Vector3& b, float fa, float fb) noexcept { return a * fa + b * fb; }
+	constexpr Vector4 Combine(const Vector4& a, const Vector4& b, float fa, float fb) noexcept { return a * fa + b * fb; }
 
 	/*********************************************************************
 	******************************* Matrix *******************************
 	**********************************************************************/
-
-	Matrix3 Inverse(const Matrix3& m);
-	Matrix4 Inverse(const Matrix4& m);
-
-	Matrix3 Transpose(const Matrix3& m);
-	Matrix4 Transpose(const Matrix4& m);
-
-	float Determinant(const Matrix3& m);
-	float Determinant(const Matrix4& m);
-
-	Matrix4 Ortho(float left, float right, float bottom, float top, float zNear = 0.1f, float zFar=1000.0f);
-	Matrix4 Perspective(float fovy, float aspect, float zNear, float zFar);
-	Matrix4 LookAt(const Vector3& eye, const Vector3& center, const Vector3& up);
-	Matrix4 Translate(const Matrix4& m, const Vector3& v);
-	Matrix4 Rotate(const Matrix4& m, float angle, const Vector3& v);
-	Matrix4 Rotate(const Matrix4& m, const Quaternion& q);
-	Vector3 Rotate(const Quaternion& q, const Vector3& v);
-	Matrix4 Scale(const Matrix4& m, const Vector3& v);
-	Vector3 Unproject(const Vector3& win, const Matrix4& modelview, const Matrix4& proj, const Vector4& viewport);
-
-	bool DecomposeTransformMatrix(const Matrix4& m, Vector3& translation, Quaternion& rotation, Vector3& scale, Vector3& skew, Vector4& perspective);
+	// defined in math/Math.inl, which math/Matrix.h pulls in once every type is complete
+
+	constexpr Matrix3 Inverse(const Matrix3& m) noexcept;
+	inline Matrix4 Inverse(const Matrix4& m) noexcept;
+	// Cheaper inverses for known matrix shapes, prefer them over the general cofactor Inverse
+	// m = translation * (any invertible 3x3), the last row is (0, 0, 0, 1)
+	constexpr Matrix4 InverseAffine(const Matrix4& m) noexcept;
+	// m = translation * rotation, e.g. a LookAt view matrix
+	constexpr Matrix4 InverseRigid(const Matrix4& m) noexcept;
+	// m is a Perspective (or off-center frustum) projection
+	constexpr Matrix4 InversePerspective(const Matrix4& m) noexcept;
+
+	constexpr Matrix3 Transpose(const Matrix3& m) noexcept;
+	constexpr Matrix4 Transpose(const Matrix4& m) noexcept;
+
+	constexpr float Determinant(const Matrix3& m) noexcept;
+	constexpr float Determinant(const Matrix4& m) noexcept;
+
+	constexpr Matrix4 Ortho(float left, float right, float bottom, float top, float zNear = 0.1f, float zFar = 1000.0f) noexcept;
+	inline Matrix4 Perspective(float fovy, float aspect, float zNear, float zFar) noexcept;
+	inline Matrix4 LookAt(const Vector3& eye, const Vector3& center, const Vector3& up) noexcept;
+	constexpr Matrix4 Translate(const Matrix4& m, const Vector3& v) noexcept;
+	inline Matrix4 Rotate(const Matrix4& m, float angle, const Vector3& v) noexcept;
+	inline Matrix4 Rotate(const Matrix4& m, const Quaternion& q) noexcept;
+	inline Vector3 Rotate(const Quaternion& q, const Vector3& v) noexcept;
+	constexpr Matrix4 Scale(const Matrix4& m, const Vector3& v) noexcept;
+	inline Vector3 Unproject(const Vector3& win, const Matrix4& modelview, const Matrix4& proj, const Vector4& viewport) noexcept;
+	inline Vector3 Unproject(const Vector3& win, const Matrix4& inverseViewProjection, const Vector4& viewport) noexcept;
+
+	// Translate(position) * Rotate(theta around +Y) * Scale(scale) for a batch of entities stored as
+	// separate arrays, four entities per SIMD iteration. All spans must have the same size.
+	// The rotation uses the FastSinCos kernel (math/FastMath.h).
+	inline void ComposeTRS(std::span<const Vector3> position, std::span<const float> theta, std::span<const Vector3> scale, std::span<Matrix4> out) noexcept;
+
+	inline bool DecomposeTransformMatrix(const Matrix4& m, Vector3& translation, Quaternion& rotation, Vector3& scale, Vector3& skew, Vector4& perspective) noexcept;
 
 	/*********************************************************************
 	******************************* Quaternion ***************************
 	**********************************************************************/
-	float Dot(const Quaternion& a, const Quaternion& b);
-	Quaternion Mix(const Quaternion& a, const Quaternion& b, float t);
-	float Length(const Quaternion& q);
-	Quaternion Normalize(const Quaternion& q);
-	Quaternion Conjugate(const Quaternion& q);
-	Quaternion Inverse(const Quaternion& q);
+	constexpr float Dot(const Quaternion& a, const Quaternion& b) noexcept;
+	inline Quaternion Mix(const Quaternion& a, const Quaternion& b, float t) noexcept;
+	inline float Length(const Quaternion& q) noexcept;
+	inline Quaternion Normalize(const Quaternion& q) noexcept;
+	constexpr Quaternion Conjugate(const Quaternion& q) noexcept;
+	constexpr Quaternion Inverse(const Quaternion& q) noexcept;
 
 }
 
-
-
+#include "math/Matrix.h"
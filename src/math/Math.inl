@@ -1,215 +1,64 @@
-#include "Math.h"
-#include "math/Matrix.h"
+#pragma once
 
-namespace Math {
-	float Radians(float degrees) { return degrees * PI / 180.f; }
-	Vector3 Radians(const Vector3& degrees) { return degrees * PI / 180.f; }
-	float Degrees(float radians) { return radians * 180.f / PI; }
-	Vector3 Degrees(const Vector3& radians) { return radians * 180.f / PI; }
-
-	float Sin(float v) { return sinf(v); }
-	Vector2 Sin(const Vector2& v) { return Vector2(sinf(v.x), sinf(v.y)); }
-	Vector3 Sin(const Vector3& v) { return Vector3(sinf(v.x), sinf(v.y), sinf(v.z)); }
-	Vector4 Sin(const Vector4& v) { return Vector4(sinf(v.x), sinf(v.y), sinf(v.z), sinf(v.w)); }
-	float Cos(float v) { return cosf(v); }
-	Vector2 Cos(const Vector2& v) { return Vector2(cosf(v.x), cosf(v.y)); }
-	Vector3 Cos(const Vector3& v) { return Vector3(cosf(v.x), cosf(v.y), cosf(v.z)); }
-	Vector4 Cos(const Vector4& v) { return Vector4(cosf(v.x), cosf(v.y), cosf(v.z), cosf(v.w)); }
-	float Tan(float v) { return tanf(v); }
-	Vector2 Tan(const Vector2& v) { return Vector2(tanf(v.x), tanf(v.y)); }
-	Vector3 Tan(const Vector3& v) { return Vector3(tanf(v.x), tanf(v.y), tanf(v.z)); }
-	Vector4 Tan(const Vector4& v) { return Vector4(tanf(v.x), tanf(v.y), tanf(v.z), tanf(v.w)); }
-
-	float Min(float a, float b) { return a < b ? a : b; }
-	float Max(float a, float b) { return a > b ? a : b; }
-
-	bool EpsilonEqual(float a, float b, float epsilon /* = EPSILONF*/) { return fabsf(a - b) < epsilon; }
-	bool EpsilonEqual(const Vector2& a, const Vector2& b, float epsilon /* = EPSILONF*/) { return EpsilonEqual(a.x, b.x, epsilon) && EpsilonEqual(a.y, b.y, epsilon); }
-
-	float Clamp(float v, float min, float max) { return v < min ? min : v > max ? max : v; }
-	/*********************************************************************
-	******************************* Vector *******************************
-	**********************************************************************/
-	float* Ptr(Vector2& v) { return &v.x; }
-	const float* Ptr(const Vector2& v) { return &v.x; }
-	float* Ptr(Vector3& v) { return &v.x; }
-	const float* Ptr(const Vector3& v) { return &v.x; }
-	float* Ptr(Vector4& v) { return &v.x; }
-	const float* Ptr(const Vector4& v) { return &v.x; }
-
-	float Dot(const Vector2& a, const Vector2& b) {
-		Vector2 tmp(a * b);
-		return tmp.x + tmp.y;
-	}
-	float Dot(const Vector3& a, const Vector3& b) {
-		Vector3 tmp(a * b);
-		return tmp.x + tmp.y + tmp.z;
-	}
-	float Dot(const Vector4& a, const Vector4& b) {
-		Vector4 tmp(a * b);
-		return tmp.x + tmp.y + tmp.z + tmp.w;
-	}
-
-	Vector2 Cross(const Vector2& a, const Vector2& b) {
-		return { a.x * b.y - a.y * b.x };
-	}
-	Vector3 Cross(const Vector3& a, const Vector3& b) {
-		return { a.y * b.z - a.z * b.y,
-			   a.z * b.x - a.x * b.z,
-			   a.x * b.y - a.y * b.x };
-	}
-	Vector4 Cross(const Vector4& a, const Vector4& b) {
-		return {
-			a.y * b.z - a.z * b.y,
-			a.z * b.x - a.x * b.z,
-			a.x * b.y - a.y * b.x,
-			0
-		};
-	}
-
-	float Length(const Vector2& v) {
-		return sqrtf(Dot(v, v));
-	}
-	float Length(const Vector3& v) {
-		return sqrtf(Dot(v, v));
-	}
-	float Length(const Vector4& v) {
-		return sqrtf(Dot(v, v));
-	}
-
-
-
-	Vector2 Normalize(const Vector2& v) {
-		return v / Length(v);
-	}
-	Vector3 Normalize(const Vector3& v) {
-		return v / Length(v);
-	}
-	Vector4 Normalize(const Vector4& v) {
-		return v / Length(v);
-	}
-
-	float Mix(const float& a, const float& b, float t) {
-		return a * (1 - t) + b * t;
-	}
-	Vector2 Mix(const Vector2& a, const Vector2& b, float t) {
-		return a * (1 - t) + b * t;
-	}
-	Vector3 Mix(const Vector3& a, const Vector3& b, float t) {
-		return a * (1 - t) + b * t;
-	}
-	Vector4 Mix(const Vector4& a, const Vector4& b, float t) {
-		return a * (1 - t) + b * t;
-	}
+// Matrix and quaternion helpers of the Math namespace; included by math/Matrix.h once every type is complete.
 
-	Vector2 Scale(const Vector2& v, float length) {
-		return Normalize(v) * length;
-	}
-	Vector3 Scale(const Vector3& v, float length) {
-		return Normalize(v) * length;
-	}
-	Vector4 Scale(const Vector4& v, float length) {
-		return Normalize(v) * length;
-	}
-
-	Vector3 Unproject(const Vector3& win, const Matrix4& modelview, const Matrix4& proj, const Vector4& viewport)
-	{
-		Matrix4 Inverse = Math::Inverse(proj * modelview);
-
-		Vector4 tmp = Vector4(win, 1.0);
-		tmp.x = (tmp.x - float(viewport[0])) / float(viewport[2]);
-		tmp.y = (tmp.y - float(viewport[1])) / float(viewport[3]);
-		tmp = tmp * static_cast<float>(2) - static_cast<float>(1);
-
-		Vector4 obj = Inverse * tmp;
-		obj /= obj.w;
-		return Vector3(obj);
-	}
-
-	Vector2 Combine(const Vector2& a, const Vector2& b, float fa, float fb) {
-		return a * fa + b * fb;
-	}
-	Vector3 Combine(const Vector3& a, const Vector3& b, float fa, float fb) {
-		return a * fa + b * fb;
-	}
-	Vector4 Combine(const Vector4& a, const Vector4& b, float fa, float fb) {
-		return a * fa + b * fb;
-	}
+#include "math/Simd.h"
+#include "math/FastMath.h"
 
+namespace Math {
 	/*********************************************************************
 	******************************* Matrix *******************************
 	**********************************************************************/
-	float* Ptr(Matrix3& m) {
+	constexpr float* Ptr(Matrix3& m) noexcept {
 		return &m.value0[0];
 	}
-	const float* Ptr(const Matrix3& m) {
+	constexpr const float* Ptr(const Matrix3& m) noexcept {
 		return &m.value0[0];
 	}
-	float* Ptr(Matrix4& m) {
+	constexpr float* Ptr(Matrix4& m) noexcept {
 		return &m.value0[0];
 	}
-	const float* Ptr(const Matrix4& m) {
+	constexpr const float* Ptr(const Matrix4& m) noexcept {
 		return &m.value0[0];
 	}
 
 
-	Matrix4 Inverse(const Matrix4& m) {
-		float Coef00 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
-		float Coef02 = m[1][2] * m[3][3] - m[3][2] * m[1][3];
-		float Coef03 = m[1][2] * m[2][3] - m[2][2] * m[1][3];
-
-		float Coef04 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
-		float Coef06 = m[1][1] * m[3][3] - m[3][1] * m[1][3];
-		float Coef07 = m[1][1] * m[2][3] - m[2][1] * m[1][3];
-
-		float Coef08 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
-		float Coef10 = m[1][1] * m[3][2] - m[3][1] * m[1][2];
-		float Coef11 = m[1][1] * m[2][2] - m[2][1] * m[1][2];
-
-		float Coef12 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
-		float Coef14 = m[1][0] * m[3][3] - m[3][0] * m[1][3];
-		float Coef15 = m[1][0] * m[2][3] - m[2][0] * m[1][3];
-
-		float Coef16 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
-		float Coef18 = m[1][0] * m[3][2] - m[3][0] * m[1][2];
-		float Coef19 = m[1][0] * m[2][2] - m[2][0] * m[1][2];
-
-		float Coef20 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
-		float Coef22 = m[1][0] * m[3][1] - m[3][0] * m[1][1];
-		float Coef23 = m[1][0] * m[2][1] - m[2][0] * m[1][1];
-
-		Vector4 Fac0(Coef00, Coef00, Coef02, Coef03);
-		Vector4 Fac1(Coef04, Coef04, Coef06, Coef07);
-		Vector4 Fac2(Coef08, Coef08, Coef10, Coef11);
-		Vector4 Fac3(Coef12, Coef12, Coef14, Coef15);
-		Vector4 Fac4(Coef16, Coef16, Coef18, Coef19);
-		Vector4 Fac5(Coef20, Coef20, Coef22, Coef23);
-
-		Vector4 Vec0(m[1][0], m[0][0], m[0][0], m[0][0]);
-		Vector4 Vec1(m[1][1], m[0][1], m[0][1], m[0][1]);
-		Vector4 Vec2(m[1][2], m[0][2], m[0][2], m[0][2]);
-		Vector4 Vec3(m[1][3], m[0][3], m[0][3], m[0][3]);
-
-		Vector4 Inv0(Vec1 * Fac0 - Vec2 * Fac1 + Vec3 * Fac2);
-		Vector4 Inv1(Vec0 * Fac0 - Vec2 * Fac3 + Vec3 * Fac4);
-		Vector4 Inv2(Vec0 * Fac1 - Vec1 * Fac3 + Vec3 * Fac5);
-		Vector4 Inv3(Vec0 * Fac2 - Vec1 * Fac4 + Vec2 * Fac5);
-
-		Vector4 SignA(+1, -1, +1, -1);
-		Vector4 SignB(-1, +1, -1, +1);
-		Matrix4 Inverse(Inv0 * SignA, Inv1 * SignB, Inv2 * SignA, Inv3 * SignB);
-
-		Vector4 Row0(Inverse[0][0], Inverse[1][0], Inverse[2][0], Inverse[3][0]);
+	inline Matrix4 Inverse(const Matrix4& m) noexcept {
+		Matrix4 Inverse;
+		Simd::InverseMatrix4(Ptr(m), Ptr(Inverse));
+		return Inverse;
+	}
 
-		Vector4 Dot0(m[0] * Row0);
-		float Dot1 = (Dot0.x + Dot0.y) + (Dot0.z + Dot0.w);
+	constexpr Matrix4 InverseAffine(const Matrix4& m) noexcept {
+		const Matrix3 Rotate = Inverse(Matrix3(m));
+		const Vector3 Translate = -(Rotate * Vector3(m[3]));
+		return Matrix4(Vector4(Rotate[0], 0), Vector4(Rotate[1], 0), Vector4(Rotate[2], 0), Vector4(Translate, 1));
+	}
 
-		float OneOverDeterminant = static_cast<float>(1) / Dot1;
+	constexpr Matrix4 InverseRigid(const Matrix4& m) noexcept {
+		if (std::is_constant_evaluated()) {
+			const Matrix3 Rotate = Transpose(Matrix3(m));
+			const Vector3 Translate = -(Rotate * Vector3(m[3]));
+			return Matrix4(Vector4(Rotate[0], 0), Vector4(Rotate[1], 0), Vector4(Rotate[2], 0), Vector4(Translate, 1));
+		}
+		Matrix4 Result;
+		Simd::InverseRigidMatrix4(Ptr(m), Ptr(Result));
+		return Result;
+	}
 
-		return Inverse * OneOverDeterminant;
+	constexpr Matrix4 InversePerspective(const Matrix4& m) noexcept {
+		// m = | a 0 e 0 |    inverse = | 1/a  0   0   e/a |
+		//     | 0 b f 0 |              |  0  1/b  0   f/b |
+		//     | 0 0 c d |              |  0   0   0   -1  |
+		//     | 0 0 -1 0|              |  0   0  1/d  c/d |
+		const float a = m[0][0], b = m[1][1], c = m[2][2], d = m[3][2], e = m[2][0], f = m[2][1];
+		return Matrix4(1.0f / a, 0, 0, 0,
+			0, 1.0f / b, 0, 0,
+			0, 0, 0, 1.0f / d,
+			e / a, f / b, -1.0f, c / d);
 	}
 
-	Matrix3 Inverse(const Matrix3& m) {
+	constexpr Matrix3 Inverse(const Matrix3& m) noexcept {
 
 		float OneOverDeterminant = static_cast<float>(1) / (
 			+m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2])
@@ -230,24 +79,28 @@ namespace Math {
 		return Inverse;
 	}
 
-	Matrix3 Transpose(const Matrix3& m) {
+	constexpr Matrix3 Transpose(const Matrix3& m) noexcept {
 		return Matrix3(m[0][0], m[1][0], m[2][0],
 			m[0][1], m[1][1], m[2][1],
 			m[0][2], m[1][2], m[2][2]);
 	}
-	Matrix4 Transpose(const Matrix4& m) {
-		return Matrix4(m[0][0], m[1][0], m[2][0], m[3][0],
-			m[0][1], m[1][1], m[2][1], m[3][1],
-			m[0][2], m[1][2], m[2][2], m[3][2],
-			m[0][3], m[1][3], m[2][3], m[3][3]);
+	constexpr Matrix4 Transpose(const Matrix4& m) noexcept {
+		if (std::is_constant_evaluated())
+			return Matrix4(m[0][0], m[1][0], m[2][0], m[3][0],
+				m[0][1], m[1][1], m[2][1], m[3][1],
+				m[0][2], m[1][2], m[2][2], m[3][2],
+				m[0][3], m[1][3], m[2][3], m[3][3]);
+		Matrix4 Result;
+		Simd::TransposeMatrix4(Ptr(m), Ptr(Result));
+		return Result;
 	}
 
-	float Determinant(const Matrix3& m) {
+	constexpr float Determinant(const Matrix3& m) noexcept {
 		return m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2])
 			- m[1][0] * (m[0][1] * m[2][2] - m[2][1] * m[0][2])
 			+ m[2][0] * (m[0][1] * m[1][2] - m[1][1] * m[0][2]);
 	}
-	float Determinant(const Matrix4& m) {
+	constexpr float Determinant(const Matrix4& m) noexcept {
 		float SubFactor00 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
 		float SubFactor01 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
 		float SubFactor02 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
@@ -266,7 +119,7 @@ namespace Math {
 			m[0][2] * DetCof[2] + m[0][3] * DetCof[3];
 	}
 
-	Matrix4 Ortho(float left, float right, float bottom, float top, float zNear, float zFar) {
+	constexpr Matrix4 Ortho(float left, float right, float bottom, float top, float zNear, float zFar) noexcept {
 		Matrix4 Result(static_cast<float>(1));
 		Result[0][0] = static_cast<float>(2) / (right - left);
 		Result[1][1] = static_cast<float>(2) / (top - bottom);
@@ -277,8 +130,8 @@ namespace Math {
 		return Result;
 	}
 
-	Matrix4 Perspective(float fovy, float aspect, float zNear, float zFar) {
-		assert(abs(aspect - EPSILONF) > static_cast<float>(0));
+	inline Matrix4 Perspective(float fovy, float aspect, float zNear, float zFar) noexcept {
+		assert(std::abs(aspect - EPSILONF) > static_cast<float>(0));
 
 		float const tanHalfFovy = tan(fovy / static_cast<float>(2));
 
@@ -291,7 +144,7 @@ namespace Math {
 		return Result;
 	}
 
-	Matrix4 LookAt(const Vector3& eye, const Vector3& center, const Vector3& up) {
+	inline Matrix4 LookAt(const Vector3& eye, const Vector3& center, const Vector3& up) noexcept {
 		Vector3 const f(Normalize(center - eye));
 		Vector3 const s(Normalize(Cross(f, up)));
 		Vector3 const u(Cross(s, f));
@@ -312,13 +165,13 @@ namespace Math {
 		return Result;
 	}
 
-	Matrix4 Translate(const Matrix4& m, const Vector3& v) {
+	constexpr Matrix4 Translate(const Matrix4& m, const Vector3& v) noexcept {
 		Matrix4 Result(m);
 		Result[3] = m[0] * v[0] + m[1] * v[1] + m[2] * v[2] + m[3];
 		return Result;
 	}
 
-	Matrix4 Rotate(const Matrix4& m, float angle, const Vector3& v) {
+	inline Matrix4 Rotate(const Matrix4& m, float angle, const Vector3& v) noexcept {
 		float const c = cos(angle);
 		float const s = sin(angle);
 
@@ -346,13 +199,13 @@ namespace Math {
 		return Result;
 	}
 
-	Matrix4 Rotate(const Matrix4& m, const Quaternion& q) {
+	inline Matrix4 Rotate(const Matrix4& m, const Quaternion& q) noexcept {
 		return m * Matrix4(q);
 	}
 
-	Vector3 Rotate(const Quaternion& q, const Vector3& v) { return q * v; }
+	inline Vector3 Rotate(const Quaternion& q, const Vector3& v) noexcept { return q * v; }
 
-	Matrix4 Scale(const Matrix4& m, const Vector3& v) {
+	constexpr Matrix4 Scale(const Matrix4& m, const Vector3& v) noexcept {
 		Matrix4 Result(m);
 		Result[0][0] *= v.x;
 		Result[1][1] *= v.y;
@@ -360,7 +213,37 @@ namespace Math {
 		return Result;
 	}
 
-	bool DecomposeTransformMatrix(const Matrix4& m, Vector3& translation, Quaternion& rotation, Vector3& scale, Vector3& skew, Vector4& perspective) {
+	inline void ComposeTRS(std::span<const Vector3> position, std::span<const float> theta, std::span<const Vector3> scale, std::span<Matrix4> out) noexcept {
+		assert(position.size() == out.size() && theta.size() == out.size() && scale.size() == out.size());
+
+		const size_t count = out.size();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			alignas(16) float lanes[6][4];
+			for (int j = 0; j < 4; ++j) {
+				const Vector3& p = position[i + j];
+				const Vector3& s = scale[i + j];
+				lanes[0][j] = p.x; lanes[1][j] = p.y; lanes[2][j] = p.z;
+				lanes[3][j] = s.x; lanes[4][j] = s.y; lanes[5][j] = s.z;
+			}
+			Simd::Float4 sinTheta, cosTheta;
+			Simd::SinCos(Simd::LoadUnaligned(&theta[i]), sinTheta, cosTheta);
+			Simd::ComposeTRS4(Simd::Load(lanes[0]), Simd::Load(lanes[1]), Simd::Load(lanes[2]), sinTheta,
+				cosTheta, Simd::Load(lanes[3]), Simd::Load(lanes[4]), Simd::Load(lanes[5]), Ptr(out[i]));
+		}
+		for (; i < count; ++i) {
+			float s = 0, c = 0;
+			FastSinCos(theta[i], s, c);
+			const Vector3& p = position[i];
+			const Vector3& k = scale[i];
+			out[i] = Matrix4(c * k.x, 0, -s * k.x, 0,
+				0, k.y, 0, 0,
+				s * k.z, 0, c * k.z, 0,
+				p.x, p.y, p.z, 1);
+		}
+	}
+
+	inline bool DecomposeTransformMatrix(const Matrix4& m, Vector3& translation, Quaternion& rotation, Vector3& scale, Vector3& skew, Vector4& perspective) noexcept {
 		Matrix4 LocalMatrix(m);
 
 		// Normalize the matrix.
@@ -515,11 +398,11 @@ namespace Math {
 	}
 
 
-	float Dot(const Quaternion& a, const Quaternion& b) {
+	constexpr float Dot(const Quaternion& a, const Quaternion& b) noexcept {
 		return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
 	}
 
-	Quaternion Mix(const Quaternion& a, const Quaternion& b, float t) {
+	inline Quaternion Mix(const Quaternion& a, const Quaternion& b, float t) noexcept {
 		float const cosTheta = Dot(a, b);
 
 		// Perform a linear interpolation when cosTheta is close to 1 to avoid side effect of sin(angle) becoming a zero denominator
@@ -540,20 +423,35 @@ namespace Math {
 		}
 	}
 
-	float Length(const Quaternion& q) {
+	inline float Length(const Quaternion& q) noexcept {
 		return sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
 	}
-	Quaternion Normalize(const Quaternion& q) {
+	inline Quaternion Normalize(const Quaternion& q) noexcept {
 		float len = Length(q);
 		return Quaternion(q.w / len, q.x / len, q.y / len, q.z / len);
 	}
-	Quaternion Conjugate(const Quaternion& q) {
+	constexpr Quaternion Conjugate(const Quaternion& q) noexcept {
 		return Quaternion(q.w, -q.x, -q.y, -q.z);
 	}
-	Quaternion Inverse(const Quaternion& q) {
+	constexpr Quaternion Inverse(const Quaternion& q) noexcept {
 		return Conjugate(q) / (q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
 	}
 
 
-}
+	inline Vector3 Unproject(const Vector3& win, const Matrix4& modelview, const Matrix4& proj, const Vector4& viewport) noexcept
+	{
+		return Unproject(win, Math::Inverse(proj * modelview), viewport);
+	}
 
+	inline Vector3 Unproject(const Vector3& win, const Matrix4& Inverse, const Vector4& viewport) noexcept
+	{
+		Vector4 tmp = Vector4(win, 1.0);
+		tmp.x = (tmp.x - float(viewport[0])) / float(viewport[2]);
+		tmp.y = (tmp.y - float(viewport[1])) / float(viewport[3]);
+		tmp = tmp * static_cast<float>(2) - static_cast<float>(1);
+
+		Vector4 obj = Inverse * tmp;
+		obj /= obj.w;
+		return Vector3(obj);
+	}
+}
@@ -16,73 +16,137 @@ public:
 	Vector3 value2;
 
 public:
-	Matrix3();
+	constexpr Matrix3() noexcept : value0(1, 0, 0), value1(0, 1, 0), value2(0, 0, 1) {}
 
-	Matrix3(const Matrix3& m);
-	Matrix3(float diag);
-	Matrix3(float m00, float m10, float m20,
+	constexpr Matrix3(const Matrix3& m) noexcept = default;
+	constexpr Matrix3(float diag) noexcept : value0(diag, 0, 0), value1(0, diag, 0), value2(0, 0, diag) {}
+	constexpr Matrix3(float m00, float m10, float m20,
 		float m01, float m11, float m21,
-		float m02, float m12, float m22);
-	Matrix3(const Vector3& col0, const Vector3& col1, const Vector3& col2);
-
-	Vector3& operator[](int i);
-	const Vector3& operator[](int i) const;
+		float m02, float m12, float m22) noexcept
+		: value0(m00, m10, m20), value1(m01, m11, m21), value2(m02, m12, m22) {}
+	constexpr Matrix3(const Vector3& col0, const Vector3& col1, const Vector3& col2) noexcept : value0(col0), value1(col1), value2(col2) {}
+
+	constexpr Vector3& operator[](int i) noexcept {
+		assert(i < 3);
+		return i == 0 ? value0 : (i == 1 ? value1 : value2);
+	}
+	constexpr const Vector3& operator[](int i) const noexcept {
+		assert(i < 3);
+		return i == 0 ? value0 : (i == 1 ? value1 : value2);
+	}
 
 	// -- Unary arithmetic operators --
-	Matrix3& operator=(const Matrix3& m);
-	Matrix3& operator+=(const Matrix3& m);
-
-	Matrix3& operator+=(float m);
-	Matrix3& operator-=(const Matrix3& m);
-
-	Matrix3& operator-=(float m);
-	Matrix3& operator*=(const Matrix3& m);
-
-	Matrix3& operator*=(float m);
-	Matrix3& operator/=(const Matrix3& m);
-
-	Matrix3& operator/=(float m);
-
-	operator Matrix4() const;
+	constexpr Matrix3& operator=(const Matrix3& m) noexcept = default;
+	constexpr Matrix3& operator+=(const Matrix3& m) noexcept {
+		value0 += m[0];
+		value1 += m[1];
+		value2 += m[2];
+		return *this;
+	}
+
+	constexpr Matrix3& operator+=(float m) noexcept {
+		value0 += m;
+		value1 += m;
+		value2 += m;
+		return *this;
+	}
+	constexpr Matrix3& operator-=(const Matrix3& m) noexcept {
+		value0 -= m[0];
+		value1 -= m[1];
+		value2 -= m[2];
+		return *this;
+	}
+
+	constexpr Matrix3& operator-=(float m) noexcept {
+		value0 -= m;
+		value1 -= m;
+		value2 -= m;
+		return *this;
+	}
+	constexpr Matrix3& operator*=(const Matrix3& m) noexcept;
+
+	constexpr Matrix3& operator*=(float m) noexcept {
+		value0 *= m;
+		value1 *= m;
+		value2 *= m;
+		return *this;
+	}
+	constexpr Matrix3& operator/=(const Matrix3& m) noexcept;
+
+	constexpr Matrix3& operator/=(float m) noexcept {
+		value0 /= m;
+		value1 /= m;
+		value2 /= m;
+		return *this;
+	}
+
+	constexpr operator Matrix4() const noexcept;
 
 	static const Matrix3 ZERO;
 	static const Matrix3 IDENTITY;
 };
+inline constexpr Matrix3 Matrix3::IDENTITY(1, 0, 0, 0, 1, 0, 0, 0, 1);
+inline constexpr Matrix3 Matrix3::ZERO(0, 0, 0, 0, 0, 0, 0, 0, 0);
+
 // -- Unary operators --
-Matrix3 operator+(const Matrix3& m);
-Matrix3 operator-(const Matrix3& m);
+constexpr Matrix3 operator+(const Matrix3& m) noexcept { return m; }
+constexpr Matrix3 operator-(const Matrix3& m) noexcept { return Matrix3(-m[0], -m[1], -m[2]); }
 // -- Binary operators --
-Matrix3 operator+(const Matrix3& m, const Matrix3& s);
+constexpr Matrix3 operator+(const Matrix3& m, const Matrix3& s) noexcept { return Matrix3(m[0] + s[0], m[1] + s[1], m[2] + s[2]); }
+
+constexpr Matrix3 operator+(const float& s, const Matrix3& m) noexcept { return Matrix3(s + m[0], s + m[1], s + m[2]); }
 
-Matrix3 operator+(const float& s, const Matrix3& m);
+constexpr Matrix3 operator+(const Matrix3& m, const float& s) noexcept { return Matrix3(m[0] + s, m[1] + s, m[2] + s); }
 
-Matrix3 operator+(const Matrix3& m, const float& s);
+constexpr Matrix3 operator-(const Matrix3& m, const Matrix3& s) noexcept { return Matrix3(m[0] - s[0], m[1] - s[1], m[2] - s[2]); }
 
-Matrix3 operator-(const Matrix3& m, const Matrix3& s);
+constexpr Matrix3 operator-(const float& m, const Matrix3& s) noexcept { return Matrix3(m - s[0], m - s[1], m - s[2]); }
 
-Matrix3 operator-(const float& m, const Matrix3& s);
+constexpr Matrix3 operator-(const Matrix3& s, const float& m) noexcept { return Matrix3(s[0] - m, s[1] - m, s[2] - m); }
 
-Matrix3 operator-(const Matrix3& s, const float& m);
+constexpr Matrix3 operator*(const Matrix3& m, const Matrix3& s) noexcept {
+	const Vector3 SrcA0 = m[0];
+	const Vector3 SrcA1 = m[1];
+	const Vector3 SrcA2 = m[2];
 
-Matrix3 operator*(const Matrix3& m, const Matrix3& s);
-Vector3 operator*(const Matrix3& m, const Vector3& v);
-Vector3 operator*(const Vector3& v, const Matrix3& m);
+	const Vector3 SrcB0 = s[0];
+	const Vector3 SrcB1 = s[1];
+	const Vector3 SrcB2 = s[2];
 
-Matrix3 operator*(const float& m, const Matrix3& s);
+	return Matrix3(
+		SrcA0 * SrcB0[0] + SrcA1 * SrcB0[1] + SrcA2 * SrcB0[2],
+		SrcA0 * SrcB1[0] + SrcA1 * SrcB1[1] + SrcA2 * SrcB1[2],
+		SrcA0 * SrcB2[0] + SrcA1 * SrcB2[1] + SrcA2 * SrcB2[2]);
+}
+constexpr Vector3 operator*(const Matrix3& m, const Vector3& v) noexcept {
+	return Vector3(m[0][0] * v[0] + m[1][0] * v[1] + m[2][0] * v[2],
+		m[0][1] * v[0] + m[1][1] * v[1] + m[2][1] * v[2],
+		m[0][2] * v[0] + m[1][2] * v[1] + m[2][2] * v[2]);
+}
+constexpr Vector3 operator*(const Vector3& v, const Matrix3& m) noexcept {
+	return Vector3(m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2],
+		m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2],
+		m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2]);
+}
 
-Matrix3 operator*(const Matrix3& s, const float& m);
+constexpr Matrix3 operator*(const float& m, const Matrix3& s) noexcept { return Matrix3(m * s[0], m * s[1], m * s[2]); }
 
-Matrix3 operator/(const Matrix3& m, const Matrix3& s);
-Vector3 operator/(const Matrix3& m, const Vector3& v);
-Vector3 operator/(const Vector3& v, const Matrix3& m);
+constexpr Matrix3 operator*(const Matrix3& s, const float& m) noexcept { return Matrix3(s[0] * m, s[1] * m, s[2] * m); }
 
-Matrix3 operator/(const float& m, const Matrix3& s);
+constexpr Matrix3 operator/(const Matrix3& m, const Matrix3& s) noexcept { return Matrix3(m) /= s; }
+constexpr Vector3 operator/(const Matrix3& m, const Vector3& v) noexcept { return Math::Inverse(m) * v; }
+constexpr Vector3 operator/(const Vector3& v, const Matrix3& m) noexcept { return v * Math::Inverse(m); }
 
-Matrix3 operator/(const Matrix3& s, const float& m);
+constexpr Matrix3 operator/(const float& m, const Matrix3& s) noexcept { return Matrix3(m / s[0], m / s[1], m / s[2]); }
+
+constexpr Matrix3 operator/(const Matrix3& s, const float& m) noexcept { return Matrix3(s[0] / m, s[1] / m, s[2] / m); }
 
 // -- Boolean operators --
-bool operator==(const Matrix3& m, const Matrix3& s);
-bool operator!=(const Matrix3& m, const Matrix3& s);
+constexpr bool operator==(const Matrix3& m, const Matrix3& s) noexcept { return (m[0] == s[0]) && (m[1] == s[1]) && (m[2] == s[2]); }
+constexpr bool operator!=(const Matrix3& m, const Matrix3& s) noexcept { return (m[0] != s[0]) || (m[1] != s[1]) || (m[2] != s[2]); }
+
+constexpr Matrix3& Matrix3::operator*=(const Matrix3& m) noexcept { return (*this = *this * m); }
+constexpr Matrix3& Matrix3::operator/=(const Matrix3& m) noexcept { return *this *= Math::Inverse(m); }
 
 
 /***********************************************************************
@@ -97,73 +161,160 @@ public:
 	Vector4 value3;
 
 public:
-	Matrix4();
+	constexpr Matrix4() noexcept : value0(1, 0, 0, 0), value1(0, 1, 0, 0), value2(0, 0, 1, 0), value3(0, 0, 0, 1) {}
 
-	Matrix4(const Matrix4 & m);
-	Matrix4(float diag);
-	Matrix4(float m00, float m10, float m20, float m30,
+	constexpr Matrix4(const Matrix4 & m) noexcept = default;
+	constexpr Matrix4(float diag) noexcept : value0(diag, 0, 0, 0), value1(0, diag, 0, 0), value2(0, 0, diag, 0), value3(0, 0, 0, diag) {}
+	constexpr Matrix4(float m00, float m10, float m20, float m30,
 		float m01, float m11, float m21, float m31,
 		float m02, float m12, float m22, float m32,
-		float m03, float m13, float m23, float m33);
-	Matrix4(const Vector4 & col0, const Vector4 & col1, const Vector4 & col2, const Vector4 & col3);
-
-	Vector4& operator[](int i);
-	const Vector4& operator[](int i) const;
+		float m03, float m13, float m23, float m33) noexcept
+		: value0(m00, m10, m20, m30), value1(m01, m11, m21, m31), value2(m02, m12, m22, m32), value3(m03, m13, m23, m33) {}
+	constexpr Matrix4(const Vector4 & col0, const Vector4 & col1, const Vector4 & col2, const Vector4 & col3) noexcept
+		: value0(col0), value1(col1), value2(col2), value3(col3) {}
+
+	// columns are contiguous, so indexing is plain pointer arithmetic outside of constant evaluation
+	constexpr Vector4& operator[](int i) noexcept {
+		assert(i < 4);
+		if (std::is_constant_evaluated())
+			return i == 0 ? value0 : (i == 1 ? value1 : (i == 2 ? value2 : value3));
+		return (&value0)[i];
+	}
+	constexpr const Vector4& operator[](int i) const noexcept {
+		assert(i < 4);
+		if (std::is_constant_evaluated())
+			return i == 0 ? value0 : (i == 1 ? value1 : (i == 2 ? value2 : value3));
+		return (&value0)[i];
+	}
 
 	// -- Unary arithmetic operators --
-	Matrix4& operator=(const Matrix4 & m);
-	Matrix4& operator+=(const Matrix4 & m);
-
-	Matrix4& operator+=(float m);
-	Matrix4& operator-=(const Matrix4 & m);
-
-	Matrix4& operator-=(float m);
-	Matrix4& operator*=(const Matrix4 & m);
-
-	Matrix4& operator*=(float m);
-	Matrix4& operator/=(const Matrix4 & m);
-
-	Matrix4& operator/=(float m);
-
-	operator Matrix3() const;
+	constexpr Matrix4& operator=(const Matrix4 & m) noexcept = default;
+	constexpr Matrix4& operator+=(const Matrix4 & m) noexcept {
+		value0 += m[0];
+		value1 += m[1];
+		value2 += m[2];
+		value3 += m[3];
+		return *this;
+	}
+
+	constexpr Matrix4& operator+=(float m) noexcept {
+		value0 += m;
+		value1 += m;
+		value2 += m;
+		value3 += m;
+		return *this;
+	}
+	constexpr Matrix4& operator-=(const Matrix4 & m) noexcept {
+		value0 -= m[0];
+		value1 -= m[1];
+		value2 -= m[2];
+		value3 -= m[3];
+		return *this;
+	}
+
+	constexpr Matrix4& operator-=(float m) noexcept {
+		value0 -= m;
+		value1 -= m;
+		value2 -= m;
+		value3 -= m;
+		return *this;
+	}
+	constexpr Matrix4& operator*=(const Matrix4 & m) noexcept;
+
+	constexpr Matrix4& operator*=(float m) noexcept {
+		value0 *= m;
+		value1 *= m;
+		value2 *= m;
+		value3 *= m;
+		return *this;
+	}
+	inline Matrix4& operator/=(const Matrix4 & m) noexcept;
+
+	constexpr Matrix4& operator/=(float m) noexcept {
+		value0 /= m;
+		value1 /= m;
+		value2 /= m;
+		value3 /= m;
+		return *this;
+	}
+
+	constexpr operator Matrix3() const noexcept {
+		return Matrix3(Vector3(value0), Vector3(value1), Vector3(value2));
+	}
 
 	static const Matrix4 ZERO;
 	static const Matrix4 IDENTITY;
 };
+inline constexpr Matrix4 Matrix4::IDENTITY(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+inline constexpr Matrix4 Matrix4::ZERO(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+static_assert(sizeof(Matrix4) == 16 * sizeof(float), "Matrix4 columns must be tightly packed");
+static_assert(alignof(Matrix4) == 16, "Matrix4 must be 16-byte aligned");
 
 // -- Unary operators --
-Matrix4 operator+(const Matrix4& m);
-Matrix4 operator-(const Matrix4& m);
+constexpr Matrix4 operator+(const Matrix4& m) noexcept { return m; }
+constexpr Matrix4 operator-(const Matrix4& m) noexcept { return Matrix4(-m[0], -m[1], -m[2], -m[3]); }
 // -- Binary operators --
-Matrix4 operator+(const Matrix4& m, const Matrix4& s);
+constexpr Matrix4 operator+(const Matrix4& m, const Matrix4& s) noexcept { return Matrix4(m[0] + s[0], m[1] + s[1], m[2] + s[2], m[3] + s[3]); }
 
-Matrix4 operator+(const float& s, const Matrix4& m);
+constexpr Matrix4 operator+(const float& s, const Matrix4& m) noexcept { return Matrix4(s + m[0], s + m[1], s + m[2], s + m[3]); }
 
-Matrix4 operator+(const Matrix4& m, const float& s);
+constexpr Matrix4 operator+(const Matrix4& m, const float& s) noexcept { return Matrix4(m[0] + s, m[1] + s, m[2] + s, m[3] + s); }
 
-Matrix4 operator-(const Matrix4& m, const Matrix4& s);
+constexpr Matrix4 operator-(const Matrix4& m, const Matrix4& s) noexcept { return Matrix4(m[0] - s[0], m[1] - s[1], m[2] - s[2], m[3] - s[3]); }
 
-Matrix4 operator-(const float& m, const Matrix4& s);
+constexpr Matrix4 operator-(const float& m, const Matrix4& s) noexcept { return Matrix4(m - s[0], m - s[1], m - s[2], m - s[3]); }
 
-Matrix4 operator-(const Matrix4& s, const float& m);
+constexpr Matrix4 operator-(const Matrix4& s, const float& m) noexcept { return Matrix4(s[0] - m, s[1] - m, s[2] - m, s[3] - m); }
 
-Matrix4 operator*(const Matrix4& m, const Matrix4& s);
-Vector4 operator*(const Matrix4& m, const Vector4& v);
-Vector4 operator*(const Vector4& v, const Matrix4& m);
+constexpr Matrix4 operator*(const Matrix4& m, const Matrix4& s) noexcept {
+	if (std::is_constant_evaluated()) {
+		Matrix4 Result;
+		for (int i = 0; i < 4; ++i)
+			Result[i] = m[0] * s[i][0] + m[1] * s[i][1] + m[2] * s[i][2] + m[3] * s[i][3];
+		return Result;
+	}
+	Matrix4 Result;
+	Simd::MulMatrix4(&m.value0.x, &s.value0.x, &Result.value0.x);
+	return Result;
+}
+constexpr Vector4 operator*(const Matrix4& m, const Vector4& v) noexcept {
+	if (std::is_constant_evaluated())
+		return m[0] * v[0] + m[1] * v[1] + m[2] * v[2] + m[3] * v[3];
+	Vector4 Result;
+	Simd::MulMatrix4Vector4(&m.value0.x, &v.x, &Result.x);
+	return Result;
+}
+constexpr Vector4 operator*(const Vector4& v, const Matrix4& m) noexcept {
+	if (std::is_constant_evaluated())
+		return Vector4(Math::Dot(m[0], v), Math::Dot(m[1], v), Math::Dot(m[2], v), Math::Dot(m[3], v));
+	Vector4 Result;
+	Simd::MulVector4Matrix4(&v.x, &m.value0.x, &Result.x);
+	return Result;
+}
 
-Matrix4 operator*(const float& m, const Matrix4& s);
+constexpr Matrix4 operator*(const float& m, const Matrix4& s) noexcept { return Matrix4(m * s[0], m * s[1], m * s[2], m * s[3]); }
 
-Matrix4 operator*(const Matrix4& s, const float& m);
+constexpr Matrix4 operator*(const Matrix4& s, const float& m) noexcept { return Matrix4(s[0] * m, s[1] * m, s[2] * m, s[3] * m); }
 
-Matrix4 operator/(const Matrix4& m, const Matrix4& s);
-Vector4 operator/(const Matrix4& m, const Vector4& v);
-Vector4 operator/(const Vector4& v, const Matrix4& m);
+inline Matrix4 operator/(const Matrix4& m, const Matrix4& s) noexcept { return Matrix4(m) /= s; }
+inline Vector4 operator/(const Matrix4& m, const Vector4& v) noexcept { return Math::Inverse(m) * v; }
+inline Vector4 operator/(const Vector4& v, const Matrix4& m) noexcept { return v * Math::Inverse(m); }
 
-Matrix4 operator/(const float& m, const Matrix4& s);
+constexpr Matrix4 operator/(const float& m, const Matrix4& s) noexcept { return Matrix4(m / s[0], m / s[1], m / s[2], m / s[3]); }
 
-Matrix4 operator/(const Matrix4& s, const float& m);
+constexpr Matrix4 operator/(const Matrix4& s, const float& m) noexcept { return Matrix4(s[0] / m, s[1] / m, s[2] / m, s[3] / m); }
 
 // -- Boolean operators --
-bool operator==(const Matrix4& m, const Matrix4& s);
-bool operator!=(const Matrix4& m, const Matrix4& s);
+constexpr bool operator==(const Matrix4& m, const Matrix4& s) noexcept { return (m[0] == s[0]) && (m[1] == s[1]) && (m[2] == s[2]) && (m[3] == s[3]); }
+constexpr bool operator!=(const Matrix4& m, const Matrix4& s) noexcept { return (m[0] != s[0]) || (m[1] != s[1]) || (m[2] != s[2]) || (m[3] != s[3]); }
+
+constexpr Matrix4& Matrix4::operator*=(const Matrix4& m) noexcept { return (*this = *this * m); }
+inline Matrix4& Matrix4::operator/=(const Matrix4& m) noexcept { return *this *= Math::Inverse(m); }
+
+constexpr Matrix3::operator Matrix4() const noexcept {
+	return Matrix4(value0.x, value0.y, value0.z, 0, value1.x, value1.y, value1.z, 0, value2.x, value2.y, value2.z, 0, 0, 0, 0, 1);
+}
 
+#include "math/Quaternion.inl"
+#include "math/Math.inl"
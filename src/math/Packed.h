@@ -0,0 +1,193 @@
+#pragma once
+#include "math/Math.h"
+#include "math/Simd.h"
+#include <bit>
+#include <cstdint>
+
+// Compact storage types for vertex streams, textures and snapshots. They only store values; convert
+// to float/Vector types (explicitly) for any math. Conversions round to nearest even, like the GPU.
+//   Half        IEEE 754 binary16, 11 significant bits, max 65504
+//   SNorm16     [-1, 1] in 16 bits, same decoding as GL_SHORT with normalized = GL_TRUE
+//   UNorm8x4    four [0, 1] channels in one uint32 (RGBA8), same decoding as GL_UNSIGNED_BYTE
+//   OctNormal   unit vector as two SNorm16 on the octahedron, under 0.01 degrees of error
+
+/***********************************************************************
+******************************** Half *********************************
+***********************************************************************/
+
+struct Half {
+	uint16_t raw = 0;
+
+	constexpr Half() noexcept = default;
+	constexpr explicit Half(float v) noexcept : raw(FromFloat(v)) {}
+
+	static constexpr Half FromRaw(uint16_t raw) noexcept {
+		Half h;
+		h.raw = raw;
+		return h;
+	}
+
+	constexpr explicit operator float() const noexcept {
+		const uint32_t sign = uint32_t(raw & 0x8000u) << 16;
+		const uint32_t exponent = (raw >> 10) & 0x1fu, mantissa = raw & 0x3ffu;
+		if (exponent == 0x1f) // inf, NaNs come back quiet like vcvtph2ps does
+			return std::bit_cast<float>(sign | 0x7f800000u | (mantissa ? 0x400000u | (mantissa << 13) : 0u));
+		if (exponent == 0) {
+			// zero or denormal, mantissa * 2^-24 is exact in float
+			const float v = float(mantissa) * 5.9604644775390625e-8f;
+			return sign ? -v : v;
+		}
+		return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+	}
+
+	constexpr bool operator==(const Half&) const noexcept = default;
+
+private:
+	static constexpr uint16_t FromFloat(float v) noexcept {
+		const uint32_t bits = std::bit_cast<uint32_t>(v);
+		const uint16_t sign = uint16_t((bits >> 16) & 0x8000u);
+		const uint32_t abs = bits & 0x7fffffffu;
+
+		if (abs >= 0x7f800000u) // inf stays inf, NaN stays a quiet NaN
+			return sign | 0x7c00u | (abs > 0x7f800000u ? 0x200u | ((abs >> 13) & 0x3ffu) : 0u);
+		if (abs >= 0x477ff000u) // 65520 and above round to inf
+			return sign | 0x7c00u;
+		if (abs < 0x38800000u) { // below 2^-14 the result is a half denormal (or zero)
+			if (abs < 0x33000000u) return sign;
+			const uint32_t shift = 126 - (abs >> 23);
+			const uint32_t mantissa = (abs & 0x7fffffu) | 0x800000u;
+			const uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+			uint32_t h = mantissa >> shift;
+			if (rest > halfway || (rest == halfway && (h & 1))) ++h;
+			return sign | uint16_t(h);
+		}
+		// rebias the exponent from 127 to 15, a mantissa carry correctly bumps the exponent
+		uint32_t h = (abs - 0x38000000u) >> 13;
+		const uint32_t rest = abs & 0x1fffu;
+		if (rest > 0x1000u || (rest == 0x1000u && (h & 1))) ++h;
+		return sign | uint16_t(h);
+	}
+};
+
+static_assert(sizeof(Half) == 2, "bulk conversion treats Half arrays as uint16_t arrays");
+
+struct Half2 {
+	Half x, y;
+
+	constexpr Half2() noexcept = default;
+	constexpr explicit Half2(const Vector2& v) noexcept : x(v.x), y(v.y) {}
+	constexpr explicit operator Vector2() const noexcept { return Vector2(float(x), float(y)); }
+};
+
+struct Half3 {
+	Half x, y, z;
+
+	constexpr Half3() noexcept = default;
+	constexpr explicit Half3(const Vector3& v) noexcept : x(v.x), y(v.y), z(v.z) {}
+	constexpr explicit operator Vector3() const noexcept { return Vector3(float(x), float(y), float(z)); }
+};
+
+struct Half4 {
+	Half x, y, z, w;
+
+	constexpr Half4() noexcept = default;
+	constexpr explicit Half4(const Vector4& v) noexcept : x(v.x), y(v.y), z(v.z), w(v.w) {}
+	constexpr explicit operator Vector4() const noexcept { return Vector4(float(x), float(y), float(z), float(w)); }
+};
+
+/***********************************************************************
+****************************** Normalized *****************************
+***********************************************************************/
+
+struct SNorm16 {
+	int16_t raw = 0;
+
+	constexpr SNorm16() noexcept = default;
+	constexpr explicit SNorm16(float v) noexcept {
+		const float scaled = Math::Clamp(v, -1.0f, 1.0f) * 32767.0f;
+		raw = static_cast<int16_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+	}
+	constexpr explicit operator float() const noexcept { return Math::Max(float(raw) / 32767.0f, -1.0f); }
+};
+
+struct SNorm16x4 {
+	SNorm16 x, y, z, w;
+
+	constexpr SNorm16x4() noexcept = default;
+	constexpr explicit SNorm16x4(const Vector3& v, float w = 0.0f) noexcept : x(v.x), y(v.y), z(v.z), w(w) {}
+	constexpr explicit operator Vector3() const noexcept { return Vector3(float(x), float(y), float(z)); }
+};
+
+// r in the lowest byte, so the bytes are in RGBA order on little-endian machines
+struct UNorm8x4 {
+	uint32_t raw = 0;
+
+	constexpr UNorm8x4() noexcept = default;
+	constexpr explicit UNorm8x4(const Vector4& v) noexcept
+		: raw(Channel(v.x) | Channel(v.y) << 8 | Channel(v.z) << 16 | Channel(v.w) << 24) {}
+	constexpr explicit operator Vector4() const noexcept {
+		return Vector4(float(raw & 0xffu), float(raw >> 8 & 0xffu), float(raw >> 16 & 0xffu), float(raw >> 24)) / 255.0f;
+	}
+
+private:
+	static constexpr uint32_t Channel(float v) noexcept { return static_cast<uint32_t>(Math::Clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); }
+};
+
+/***********************************************************************
+****************************** OctNormal ******************************
+***********************************************************************/
+
+// Octahedral encoding (Cigolle et al. 2014): project onto |x| + |y| + |z| = 1 and fold the lower
+// half over the diagonals, so a unit vector fits in 2 x 16 bits.
+struct OctNormal {
+	SNorm16 u, v;
+
+	constexpr OctNormal() noexcept = default;
+	constexpr explicit OctNormal(const Vector3& n) noexcept {
+		const float sum = Math::Abs(n.x) + Math::Abs(n.y) + Math::Abs(n.z);
+		float px = n.x / sum, py = n.y / sum;
+		if (n.z < 0.0f) {
+			const float fx = (1.0f - Math::Abs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+			const float fy = (1.0f - Math::Abs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+			px = fx;
+			py = fy;
+		}
+		u = SNorm16(px);
+		v = SNorm16(py);
+	}
+
+	// unit length
+	explicit operator Vector3() const noexcept {
+		Vector3 n(float(u), float(v), 0.0f);
+		n.z = 1.0f - Math::Abs(n.x) - Math::Abs(n.y);
+		const float t = Math::Max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return Math::Normalize(n);
+	}
+};
+
+namespace Math {
+	// Bulk float <-> half, F16C/NEON when the target has it. Both spans must have the same size.
+	inline void PackHalf(std::span<const float> in, std::span<Half> out) noexcept {
+		assert(in.size() == out.size());
+		size_t i = 0;
+#if defined(MATH_SIMD_HALF)
+		for (; i + 4 <= in.size(); i += 4)
+			Simd::FloatToHalf4(&in[i], &out[i].raw);
+#endif
+		for (; i < in.size(); ++i)
+			out[i] = Half(in[i]);
+	}
+
+	inline void UnpackHalf(std::span<const Half> in, std::span<float> out) noexcept {
+		assert(in.size() == out.size());
+		size_t i = 0;
+#if defined(MATH_SIMD_HALF)
+		for (; i + 4 <= in.size(); i += 4)
+			Simd::HalfToFloat4(&in[i].raw, &out[i]);
+#endif
+		for (; i < in.size(); ++i)
+			out[i] = float(in[i]);
+	}
+}
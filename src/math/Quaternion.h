@@ -1,41 +1,81 @@
 #pragma once
 
-#include "math/Math.h"
+#include "Defines.h"
+#include "math/Vector.h"
 
 class Matrix3;
-class Vector3;
+class Matrix4;
 
-class Quaternion {
+// Stored as (x, y, z, w) and 16-byte aligned for the SIMD backend
+class alignas(16) Quaternion {
 
 public:
 	float  x{ 0.f }, y{ 0.f }, z{ 0.f }, w{ 1.0f };
 
 public:
-	Quaternion();
-	Quaternion(const Quaternion& m);
-	Quaternion(float w, float x, float y, float z);
-	Quaternion(const Vector3& eulerAngle);
-	Quaternion(const Matrix3& m);
-	Quaternion(const Matrix4& m);
-
-	float& operator[](int i);
-	const float& operator[](int i) const;
+	constexpr Quaternion() noexcept : x(0), y(0), z(0), w(0) {}
+	constexpr Quaternion(const Quaternion& m) noexcept = default;
+	constexpr Quaternion(float w, float x, float y, float z) noexcept : x(x), y(y), z(z), w(w) {}
+	inline Quaternion(const Vector3& eulerAngle) noexcept;
+	inline Quaternion(const Matrix3& m) noexcept;
+	inline Quaternion(const Matrix4& m) noexcept;
+
+	constexpr float& operator[](int i) noexcept {
+		assert(i < 4);
+		return i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w));
+	}
+	constexpr const float& operator[](int i) const noexcept {
+		assert(i < 4);
+		return i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w));
+	}
 
 	// -- Unary arithmetic operators --
-	Quaternion& operator=(const Quaternion& v);
-	Quaternion& operator+=(const Quaternion& v);
-	Quaternion& operator-=(const Quaternion& v);
-	Quaternion& operator*=(const Quaternion& v);
-	Quaternion& operator*=(float v);
-	Quaternion& operator/=(float v);
-
-	operator Matrix3() const;
-	operator Matrix4() const;
-	operator Vector3() const;
-
-	float Roll() const;
-	float Pitch() const;
-	float Yaw() const;
+	constexpr Quaternion& operator=(const Quaternion& v) noexcept = default;
+	constexpr Quaternion& operator+=(const Quaternion& q) noexcept {
+		w += q.w;
+		x += q.x;
+		y += q.y;
+		z += q.z;
+		return *this;
+	}
+	constexpr Quaternion& operator-=(const Quaternion& q) noexcept {
+		w -= q.w;
+		x -= q.x;
+		y -= q.y;
+		z -= q.z;
+		return *this;
+	}
+	constexpr Quaternion& operator*=(const Quaternion& q) noexcept {
+		Quaternion p(*this);
+
+		w = p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z;
+		x = p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y;
+		y = p.w * q.y + p.y * q.w + p.z * q.x - p.x * q.z;
+		z = p.w * q.z + p.z * q.w + p.x * q.y - p.y * q.x;
+		return *this;
+	}
+	constexpr Quaternion& operator*=(float v) noexcept {
+		w *= v;
+		x *= v;
+		y *= v;
+		z *= v;
+		return *this;
+	}
+	constexpr Quaternion& operator/=(float v) noexcept {
+		w /= v;
+		x /= v;
+		y /= v;
+		z /= v;
+		return *this;
+	}
+
+	constexpr operator Matrix3() const noexcept;
+	constexpr operator Matrix4() const noexcept;
+	inline operator Vector3() const noexcept;
+
+	inline float Roll() const noexcept;
+	inline float Pitch() const noexcept;
+	inline float Yaw() const noexcept;
 
 
 	// special values
@@ -43,28 +83,31 @@ public:
 	static const Quaternion IDENTITY;
 
 private:
-	Quaternion Matrix3ToQuaternion(const Matrix3& m);
-	Matrix3 QuaternionToMatrix3() const;
-	Vector3 QuaternionToEuler() const;
+	static inline Quaternion Matrix3ToQuaternion(const Matrix3& m) noexcept;
+	constexpr Matrix3 QuaternionToMatrix3() const noexcept;
+	inline Vector3 QuaternionToEuler() const noexcept;
 };
+inline constexpr Quaternion Quaternion::ZERO(0, 0, 0, 0);
+inline constexpr Quaternion Quaternion::IDENTITY(1, 0, 0, 0);
 
 // -- Unary operators --
-Quaternion operator+(const Quaternion& m);
-Quaternion operator-(const Quaternion& m);
+constexpr Quaternion operator+(const Quaternion& q) noexcept { return q; }
+constexpr Quaternion operator-(const Quaternion& q) noexcept { return Quaternion(-q.w, -q.x, -q.y, -q.z); }
 // -- Binary operators --
-Quaternion operator+(const Quaternion& m, const Quaternion& s);
-Quaternion operator-(const Quaternion& m, const Quaternion& s);
+constexpr Quaternion operator+(const Quaternion& m, const Quaternion& q) noexcept { return Quaternion(m) += q; }
+constexpr Quaternion operator-(const Quaternion& m, const Quaternion& q) noexcept { return Quaternion(m) -= q; }
 
-Quaternion operator*(const Quaternion& m, const Quaternion& s);
-Quaternion operator*(const float& m, const Quaternion& s);
-Quaternion operator*(const Quaternion& s, const float& m);
-Vector3 operator*(const Quaternion& q, const Vector3& v);
-Vector3 operator*(const Vector3& v, const Quaternion& q);
+constexpr Quaternion operator*(const Quaternion& m, const Quaternion& q) noexcept { return Quaternion(m) *= q; }
+constexpr Quaternion operator*(const Quaternion& q, const float& s) noexcept { return Quaternion(q.w * s, q.x * s, q.y * s, q.z * s); }
+constexpr Quaternion operator*(const float& m, const Quaternion& q) noexcept { return q * m; }
+inline Vector3 operator*(const Quaternion& q, const Vector3& v) noexcept;
+inline Vector3 operator*(const Vector3& v, const Quaternion& q) noexcept;
 
 
-Quaternion operator/(const Quaternion& s, const float& m);
+constexpr Quaternion operator/(const Quaternion& q, const float& s) noexcept { return Quaternion(q.w / s, q.x / s, q.y / s, q.z / s); }
 
 // -- Boolean operators --
-bool operator==(const Quaternion& m, const Quaternion& s);
-bool operator!=(const Quaternion& m, const Quaternion& s);
+constexpr bool operator==(const Quaternion& m, const Quaternion& s) noexcept { return m.x == s.x && m.y == s.y && m.z == s.z && m.w == s.w; }
+constexpr bool operator!=(const Quaternion& m, const Quaternion& s) noexcept { return m.x != s.x || m.y != s.y || m.z != s.z || m.w != s.w; }
 
+#include "math/Matrix.h"
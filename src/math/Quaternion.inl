@@ -0,0 +1,143 @@
+#pragma once
+
+// Out-of-class Quaternion members that need Matrix3/Matrix4 or <cmath>; included by math/Matrix.h.
+
+#include "math/Simd.h"
+
+inline Quaternion::Quaternion(const Vector3& eulerAngle) noexcept {
+	// Pitch Yaw Roll
+	Vector3 c = Math::Cos(eulerAngle * 0.5f);
+	Vector3 s = Math::Sin(eulerAngle * 0.5f);
+
+	this->w = c.x * c.y * c.z + s.x * s.y * s.z;
+	this->x = s.x * c.y * c.z - c.x * s.y * s.z;
+	this->y = c.x * s.y * c.z + s.x * c.y * s.z;
+	this->z = c.x * c.y * s.z - s.x * s.y * c.z;
+	*this = Math::Normalize(*this);
+}
+
+inline Quaternion::Quaternion(const Matrix3& m) noexcept {
+	*this = Matrix3ToQuaternion(m);
+}
+inline Quaternion::Quaternion(const Matrix4& m) noexcept {
+	*this = Matrix3ToQuaternion(Matrix3(m));
+}
+
+constexpr Quaternion::operator Matrix3() const noexcept {
+	return QuaternionToMatrix3();
+}
+
+constexpr Quaternion::operator Matrix4() const noexcept {
+	return Matrix4(operator Matrix3());
+}
+
+inline Quaternion::operator Vector3() const noexcept {
+	return QuaternionToEuler();
+}
+
+inline float Quaternion::Roll() const noexcept {
+	float a = static_cast<float>(2) * (x * y + w * z);
+	float b = w * w + x * x - y * y - z * z;
+
+	if (Math::EpsilonEqual(Vector2(a, b), Vector2(0))) //avoid atan2(0,0) - handle singularity - Matiis
+		return static_cast<float>(0);
+
+	return static_cast<float>(atan2(a, b));
+}
+inline float Quaternion::Pitch() const noexcept {
+	//return T(atan(T(2) * (q.y * q.z + q.w * q.x), q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z));
+	float a = static_cast<float>(2) * (y * z + w * x);
+	float b = w * w - x * x - y * y + z * z;
+
+	if (Math::EpsilonEqual(Vector2(b, a), Vector2(0)))//avoid atan2(0,0) - handle singularity - Matiis
+		return static_cast<float>(static_cast<float>(2) * atan2(x, w));
+
+	return static_cast<float>(atan2(a, b));
+}
+
+inline float Quaternion::Yaw() const noexcept {
+	return asin(Math::Clamp(static_cast<float>(-2) * (x * z - w * y), static_cast<float>(-1), static_cast<float>(1)));
+}
+
+inline Quaternion Quaternion::Matrix3ToQuaternion(const Matrix3& m) noexcept {
+	float fourXSquaredMinus1 = m[0][0] - m[1][1] - m[2][2];
+	float fourYSquaredMinus1 = m[1][1] - m[0][0] - m[2][2];
+	float fourZSquaredMinus1 = m[2][2] - m[0][0] - m[1][1];
+	float fourWSquaredMinus1 = m[0][0] + m[1][1] + m[2][2];
+
+	int biggestIndex = 0;
+	float fourBiggestSquaredMinus1 = fourWSquaredMinus1;
+	if (fourXSquaredMinus1 > fourBiggestSquaredMinus1)
+	{
+		fourBiggestSquaredMinus1 = fourXSquaredMinus1;
+		biggestIndex = 1;
+	}
+	if (fourYSquaredMinus1 > fourBiggestSquaredMinus1)
+	{
+		fourBiggestSquaredMinus1 = fourYSquaredMinus1;
+		biggestIndex = 2;
+	}
+	if (fourZSquaredMinus1 > fourBiggestSquaredMinus1)
+	{
+		fourBiggestSquaredMinus1 = fourZSquaredMinus1;
+		biggestIndex = 3;
+	}
+
+	float biggestVal = sqrt(fourBiggestSquaredMinus1 + static_cast<float>(1)) * static_cast<float>(0.5);
+	float mult = static_cast<float>(0.25) / biggestVal;
+
+	switch (biggestIndex)
+	{
+	case 0:
+		return Quaternion(biggestVal, (m[1][2] - m[2][1]) * mult, (m[2][0] - m[0][2]) * mult, (m[0][1] - m[1][0]) * mult);
+	case 1:
+		return Quaternion((m[1][2] - m[2][1]) * mult, biggestVal, (m[0][1] + m[1][0]) * mult, (m[2][0] + m[0][2]) * mult);
+	case 2:
+		return Quaternion((m[2][0] - m[0][2]) * mult, (m[0][1] + m[1][0]) * mult, biggestVal, (m[1][2] + m[2][1]) * mult);
+	case 3:
+		return Quaternion((m[0][1] - m[1][0]) * mult, (m[2][0] + m[0][2]) * mult, (m[1][2] + m[2][1]) * mult, biggestVal);
+	default: // Silence a -Wswitch-default warning in GCC. Should never actually get here. Assert is just for sanity.
+		assert(false);
+		return Quaternion(1, 0, 0, 0);
+	}
+}
+
+constexpr Matrix3 Quaternion::QuaternionToMatrix3() const noexcept {
+	Matrix3 Result(float(1));
+	float qxx(x * x);
+	float qyy(y * y);
+	float qzz(z * z);
+	float qxz(x * z);
+	float qxy(x * y);
+	float qyz(y * z);
+	float qwx(w * x);
+	float qwy(w * y);
+	float qwz(w * z);
+
+	Result[0][0] = 1.f - 2.f * (qyy + qzz);
+	Result[0][1] = 2.f * (qxy + qwz);
+	Result[0][2] = 2.f * (qxz - qwy);
+
+	Result[1][0] = 2.f * (qxy - qwz);
+	Result[1][1] = 1.f - 2.f * (qxx + qzz);
+	Result[1][2] = 2.f * (qyz + qwx);
+
+	Result[2][0] = 2.f * (qxz + qwy);
+	Result[2][1] = 2.f * (qyz - qwx);
+	Result[2][2] = 1.f - 2.f * (qxx + qyy);
+	return Result;
+}
+
+inline Vector3 Quaternion::QuaternionToEuler() const noexcept {
+	return Vector3(Pitch(), Yaw(), Roll());
+}
+
+inline Vector3 operator*(const Quaternion& q, const Vector3& v) noexcept {
+	Vector4 Result;
+	Simd::RotateQuaternion(&q.x, v.x, v.y, v.z, Math::Ptr(Result));
+	return Vector3(Result);
+}
+
+inline Vector3 operator*(const Vector3& v, const Quaternion& q) noexcept {
+	return Math::Inverse(q) * v;
+}
@@ -1,7 +1,13 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <cfloat>
+#include <cmath>
+#include <cstdint>
 #include <random>
+#include <span>
+
+#include "math/Simd.h"
 
 template <typename NumericType>
 using uniform_distribution = typename std::conditional<std::is_integral<NumericType>::value, std::uniform_int_distribution<NumericType>,
@@ -58,23 +64,173 @@ class DistRandomNumberGenerator {
 
 private:
 	RandomEngine mEngine;
-	DistributionFunc* mDist = nullptr;
+	DistributionFunc mDist;
 
 public:
 	template <typename... Params>
-	explicit DistRandomNumberGenerator(SeedType&& seeding, Params&&... /*params*/) : mEngine(seeding) {
-		// mdist = CHAOS_NEW_T(DistributionFunc)(std::forward<Params>(params)...);
-	}
-
-	~DistRandomNumberGenerator() { CHAOS_DELETE_T(mDist); }
+	explicit DistRandomNumberGenerator(SeedType&& seeding, Params&&... params) : mEngine(seeding), mDist(std::forward<Params>(params)...) {}
 
 	template <typename... Params>
 	void seed(Params&&... params) {
 		mEngine.seed(std::forward<Params>(params)...);
 	}
 
-	ResultType next() { return (*mDist)(mEngine); }
+	ResultType next() { return mDist(mEngine); }
 };
 
+// Counter-based generator, Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Every block of four outputs is a pure function of (seed, stream, counter): streams for threads or
+// entities are derived from an id instead of shared state, any position can be reached in O(1),
+// and results do not depend on how the work is split. Satisfies UniformRandomBitGenerator, so it
+// also plugs into RandomNumberGenerator and the std distributions.
+class Philox4x32 {
+public:
+	using result_type = uint32_t;
+	using Block = std::array<uint32_t, 4>;
+
+	explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+	void seed(uint64_t seed, uint64_t stream = 0) {
+		mKey = { uint32_t(seed), uint32_t(seed >> 32) };
+		mStream = stream;
+		mCounter = 0;
+		mIndex = 4;
+	}
+
+	// Independent generator with the same seed, e.g. one per thread or per entity id
+	Philox4x32 split(uint64_t stream) const { return Philox4x32(uint64_t(mKey[0]) | uint64_t(mKey[1]) << 32, stream); }
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+
+	result_type operator()() {
+		if (mIndex == 4) {
+			mBuffer = block(mCounter++);
+			mIndex = 0;
+		}
+		return mBuffer[mIndex++];
+	}
+
+	void discard(uint64_t n) {
+		const uint64_t buffered = 4 - mIndex;
+		if (n < buffered) {
+			mIndex += uint32_t(n);
+			return;
+		}
+		n -= buffered;
+		mCounter += n / 4;
+		mIndex = 4;
+		if (n % 4) {
+			mBuffer = block(mCounter++);
+			mIndex = uint32_t(n % 4);
+		}
+	}
+
+	Block block(uint64_t counter) const { return Generate(mKey, { uint32_t(counter), uint32_t(counter >> 32), uint32_t(mStream), uint32_t(mStream >> 32) }); }
+
+	// Uniform floats in [0, 1), four blocks per SIMD iteration. Starts at the next whole block,
+	// so the result only depends on the counter and not on earlier partial reads.
+	void fillUniform(std::span<float> out) {
+		size_t i = 0;
+		for (; i + 16 <= out.size(); i += 16, mCounter += 4) {
+			Simd::UInt4 c0 = Simd::Add(Simd::SplatUInt(uint32_t(mCounter)), Simd::LoadUInt(sLaneOffsets));
+			Simd::UInt4 c1 = Simd::SplatUInt(uint32_t(mCounter >> 32));
+			Simd::UInt4 c2 = Simd::SplatUInt(uint32_t(mStream));
+			Simd::UInt4 c3 = Simd::SplatUInt(uint32_t(mStream >> 32));
+			if (uint32_t(mCounter) > UINT32_MAX - 3) { // the low word wraps inside this group
+				alignas(16) uint32_t high[4];
+				for (uint32_t lane = 0; lane < 4; ++lane) high[lane] = uint32_t((mCounter + lane) >> 32);
+				c1 = Simd::LoadUInt(high);
+			}
+			Rounds(c0, c1, c2, c3);
+
+			// lanes hold the same word of four blocks, transpose back to block order
+			Simd::Float4 f0 = Simd::ToUnitFloat(c0), f1 = Simd::ToUnitFloat(c1), f2 = Simd::ToUnitFloat(c2), f3 = Simd::ToUnitFloat(c3);
+			Simd::Transpose(f0, f1, f2, f3);
+			alignas(16) float lanes[16];
+			Simd::Store(lanes, f0);
+			Simd::Store(lanes + 4, f1);
+			Simd::Store(lanes + 8, f2);
+			Simd::Store(lanes + 12, f3);
+			std::copy(lanes, lanes + 16, out.begin() + i);
+		}
+		for (; i < out.size(); i += 4) {
+			const Block b = block(mCounter++);
+			for (size_t j = 0; j < 4 && i + j < out.size(); ++j)
+				out[i + j] = float(b[j] >> 8) * (1.0f / 16777216.0f);
+		}
+		mIndex = 4;
+	}
+
+	// Normal floats via Box-Muller over fillUniform pairs
+	void fillNormal(std::span<float> out, float mean = 0.0f, float stddev = 1.0f) {
+		fillUniform(out);
+		const size_t pairs = out.size() / 2;
+		for (size_t i = 0; i < pairs; ++i) {
+			float sine, cosine;
+			const float radius = BoxMuller(out[2 * i], out[2 * i + 1], sine, cosine);
+			out[2 * i] = mean + stddev * radius * cosine;
+			out[2 * i + 1] = mean + stddev * radius * sine;
+		}
+		if (out.size() % 2) {
+			float extra[4];
+			fillUniform(extra);
+			float sine, cosine;
+			out[out.size() - 1] = mean + stddev * BoxMuller(out[out.size() - 1], extra[0], sine, cosine) * cosine;
+		}
+	}
+
+	static constexpr Block Generate(std::array<uint32_t, 2> key, Block counter) {
+		for (int round = 0; round < 10; ++round) {
+			const uint64_t p0 = uint64_t(sMultiplier[0]) * counter[0];
+			const uint64_t p1 = uint64_t(sMultiplier[1]) * counter[2];
+			counter = { uint32_t(p1 >> 32) ^ counter[1] ^ key[0], uint32_t(p1), uint32_t(p0 >> 32) ^ counter[3] ^ key[1], uint32_t(p0) };
+			key[0] += sWeyl[0];
+			key[1] += sWeyl[1];
+		}
+		return counter;
+	}
+
+private:
+	static constexpr uint32_t sMultiplier[2] = { 0xD2511F53u, 0xCD9E8D57u };
+	static constexpr uint32_t sWeyl[2] = { 0x9E3779B9u, 0xBB67AE85u };
+	alignas(16) static constexpr uint32_t sLaneOffsets[4] = { 0, 1, 2, 3 };
+
+	// Same rounds as Generate, one block per lane
+	void Rounds(Simd::UInt4& c0, Simd::UInt4& c1, Simd::UInt4& c2, Simd::UInt4& c3) const {
+		uint32_t k0 = mKey[0], k1 = mKey[1];
+		for (int round = 0; round < 10; ++round) {
+			Simd::UInt4 hi0, lo0, hi1, lo1;
+			Simd::MulHiLo(c0, sMultiplier[0], hi0, lo0);
+			Simd::MulHiLo(c2, sMultiplier[1], hi1, lo1);
+			c0 = Simd::Xor(Simd::Xor(hi1, c1), Simd::SplatUInt(k0));
+			c1 = lo1;
+			c2 = Simd::Xor(Simd::Xor(hi0, c3), Simd::SplatUInt(k1));
+			c3 = lo0;
+			k0 += sWeyl[0];
+			k1 += sWeyl[1];
+		}
+	}
+
+	// u0 in [0, 1) is flipped to (0, 1] so the log stays finite
+	static float BoxMuller(float u0, float u1, float& sine, float& cosine) {
+		const float angle = 6.28318530717958647692f * u1;
+		sine = std::sin(angle);
+		cosine = std::cos(angle);
+		return std::sqrt(-2.0f * std::log(1.0f - u0));
+	}
+
+	std::array<uint32_t, 2> mKey{};
+	uint64_t mStream = 0;
+	uint64_t mCounter = 0; // next block
+	Block mBuffer{};
+	uint32_t mIndex = 4;   // next word of mBuffer
+};
+
+// Known-answer vectors from the Random123 distribution
+static_assert(Philox4x32::Generate({ 0, 0 }, { 0, 0, 0, 0 }) == Philox4x32::Block{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u });
+static_assert(Philox4x32::Generate({ 0xa4093822u, 0x299f31d0u }, { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }) == Philox4x32::Block{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u });
+
 using DefaultRNG = RandomNumberGenerator<std::mt19937>;
+using ParallelRNG = RandomNumberGenerator<Philox4x32>;
 
@@ -0,0 +1,526 @@
+#pragma once
+
+/***********************************************************************
+ ******************************* Backend *******************************
+ ***********************************************************************/
+// The backend is picked at compile time. Define MATH_NO_SIMD to force the
+// scalar fallback (useful to compare results or to debug a backend).
+
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SIMD_SSE 1
+#include <immintrin.h>
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#endif
+#elif !defined(MATH_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define MATH_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define MATH_SIMD_SCALAR 1
+#endif
+
+// F16C (or NEON) converts between float and IEEE half in hardware, see math/Packed.h
+#if defined(MATH_SIMD_SSE) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define MATH_SIMD_HALF 1
+#elif defined(MATH_SIMD_NEON)
+#define MATH_SIMD_HALF 1
+#endif
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace Simd {
+
+#if defined(MATH_SIMD_SSE)
+	using Float4 = __m128;
+
+	inline Float4 Load(const float* p) { return _mm_load_ps(p); }
+	inline void Store(float* p, Float4 v) { _mm_store_ps(p, v); }
+	inline Float4 LoadUnaligned(const float* p) { return _mm_loadu_ps(p); }
+	inline void StoreUnaligned(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+	inline Float4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+	inline Float4 Splat(float s) { return _mm_set1_ps(s); }
+	inline float First(Float4 v) { return _mm_cvtss_f32(v); }
+
+	inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+	inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+	inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+	inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+
+	// (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W>
+	inline Float4 Swizzle(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X)); }
+
+	// (a[X], a[Y], b[Z], b[W])
+	template <int X, int Y, int Z, int W>
+	inline Float4 Shuffle(Float4 a, Float4 b) { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X)); }
+
+	template <int I>
+	inline Float4 SplatLane(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)); }
+
+	// -- 32-bit unsigned integer lanes --
+	using UInt4 = __m128i;
+
+	inline UInt4 LoadUInt(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+	inline void StoreUInt(uint32_t* p, UInt4 v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+	inline UInt4 SplatUInt(uint32_t s) { return _mm_set1_epi32(static_cast<int>(s)); }
+	inline UInt4 Add(UInt4 a, UInt4 b) { return _mm_add_epi32(a, b); }
+	inline UInt4 Xor(UInt4 a, UInt4 b) { return _mm_xor_si128(a, b); }
+
+	// full 64-bit products a * m, split into the high and low 32 bits
+	inline void MulHiLo(UInt4 a, uint32_t m, UInt4& hi, UInt4& lo) {
+		const __m128i mm = _mm_set1_epi32(static_cast<int>(m));
+		const __m128i even = _mm_mul_epu32(a, mm);                   // (lo0, hi0, lo2, hi2)
+		const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), mm); // (lo1, hi1, lo3, hi3)
+		lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+	}
+
+	// top 24 bits as a float in [0, 1)
+	inline Float4 ToUnitFloat(UInt4 v) { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 8)), _mm_set1_ps(1.0f / 16777216.0f)); }
+
+	// -- Min/max and comparisons, masks come back as one bit per lane --
+	inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+	inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+	inline int LessMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+	inline int LessEqualMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+
+	// -- Bit-level access, integer lanes are read as signed where it matters --
+	inline UInt4 Sub(UInt4 a, UInt4 b) { return _mm_sub_epi32(a, b); }
+	inline UInt4 And(UInt4 a, UInt4 b) { return _mm_and_si128(a, b); }
+	template <int N>
+	inline UInt4 ShiftLeft(UInt4 v) { return _mm_slli_epi32(v, N); }
+	template <int N>
+	inline UInt4 ShiftRight(UInt4 v) { return _mm_srli_epi32(v, N); }
+	inline UInt4 RoundToInt(Float4 v) { return _mm_cvtps_epi32(v); }
+	inline Float4 ToFloat(UInt4 v) { return _mm_cvtepi32_ps(v); }
+	inline UInt4 AsUInt(Float4 v) { return _mm_castps_si128(v); }
+	inline Float4 AsFloat(UInt4 v) { return _mm_castsi128_ps(v); }
+
+#elif defined(MATH_SIMD_NEON)
+	using Float4 = float32x4_t;
+
+	inline Float4 Load(const float* p) { return vld1q_f32(p); }
+	inline void Store(float* p, Float4 v) { vst1q_f32(p, v); }
+	inline Float4 LoadUnaligned(const float* p) { return vld1q_f32(p); }
+	inline void StoreUnaligned(float* p, Float4 v) { vst1q_f32(p, v); }
+	inline Float4 Set(float x, float y, float z, float w) {
+		alignas(16) const float v[4] = { x, y, z, w };
+		return vld1q_f32(v);
+	}
+	inline Float4 Splat(float s) { return vdupq_n_f32(s); }
+	inline float First(Float4 v) { return vgetq_lane_f32(v, 0); }
+
+	inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+	inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+	inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+	inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+
+	template <int X, int Y, int Z, int W>
+	inline Float4 Shuffle(Float4 a, Float4 b) {
+#if defined(__clang__)
+		return __builtin_shufflevector(a, b, X, Y, Z + 4, W + 4);
+#else
+		Float4 r = vdupq_n_f32(vgetq_lane_f32(a, X));
+		r = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+		r = vsetq_lane_f32(vgetq_lane_f32(b, Z), r, 2);
+		return vsetq_lane_f32(vgetq_lane_f32(b, W), r, 3);
+#endif
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline Float4 Swizzle(Float4 v) { return Shuffle<X, Y, Z, W>(v, v); }
+
+	template <int I>
+	inline Float4 SplatLane(Float4 v) { return vdupq_laneq_f32(v, I); }
+
+	// -- 32-bit unsigned integer lanes --
+	using UInt4 = uint32x4_t;
+
+	inline UInt4 LoadUInt(const uint32_t* p) { return vld1q_u32(p); }
+	inline void StoreUInt(uint32_t* p, UInt4 v) { vst1q_u32(p, v); }
+	inline UInt4 SplatUInt(uint32_t s) { return vdupq_n_u32(s); }
+	inline UInt4 Add(UInt4 a, UInt4 b) { return vaddq_u32(a, b); }
+	inline UInt4 Xor(UInt4 a, UInt4 b) { return veorq_u32(a, b); }
+
+	inline void MulHiLo(UInt4 a, uint32_t m, UInt4& hi, UInt4& lo) {
+		const uint64x2_t p01 = vmull_u32(vget_low_u32(a), vdup_n_u32(m));
+		const uint64x2_t p23 = vmull_u32(vget_high_u32(a), vdup_n_u32(m));
+		lo = vcombine_u32(vmovn_u64(p01), vmovn_u64(p23));
+		hi = vcombine_u32(vshrn_n_u64(p01, 32), vshrn_n_u64(p23, 32));
+	}
+
+	inline Float4 ToUnitFloat(UInt4 v) { return vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(v, 8)), vdupq_n_f32(1.0f / 16777216.0f)); }
+
+	// -- Min/max and comparisons, masks come back as one bit per lane --
+	inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+	inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+	inline int MoveMask(uint32x4_t m) {
+		const uint32x4_t bits = { 1, 2, 4, 8 };
+		return static_cast<int>(vaddvq_u32(vandq_u32(m, bits)));
+	}
+	inline int LessMask(Float4 a, Float4 b) { return MoveMask(vcltq_f32(a, b)); }
+	inline int LessEqualMask(Float4 a, Float4 b) { return MoveMask(vcleq_f32(a, b)); }
+
+	// -- Bit-level access, integer lanes are read as signed where it matters --
+	inline UInt4 Sub(UInt4 a, UInt4 b) { return vsubq_u32(a, b); }
+	inline UInt4 And(UInt4 a, UInt4 b) { return vandq_u32(a, b); }
+	template <int N>
+	inline UInt4 ShiftLeft(UInt4 v) { return vshlq_n_u32(v, N); }
+	template <int N>
+	inline UInt4 ShiftRight(UInt4 v) { return vshrq_n_u32(v, N); }
+	inline UInt4 RoundToInt(Float4 v) { return vreinterpretq_u32_s32(vcvtnq_s32_f32(v)); }
+	inline Float4 ToFloat(UInt4 v) { return vcvtq_f32_s32(vreinterpretq_s32_u32(v)); }
+	inline UInt4 AsUInt(Float4 v) { return vreinterpretq_u32_f32(v); }
+	inline Float4 AsFloat(UInt4 v) { return vreinterpretq_f32_u32(v); }
+
+#else
+	struct Float4 {
+		float v[4];
+	};
+
+	inline Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+	inline void Store(float* p, Float4 v) {
+		p[0] = v.v[0];
+		p[1] = v.v[1];
+		p[2] = v.v[2];
+		p[3] = v.v[3];
+	}
+	inline Float4 LoadUnaligned(const float* p) { return Load(p); }
+	inline void StoreUnaligned(float* p, Float4 v) { Store(p, v); }
+	inline Float4 Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+	inline Float4 Splat(float s) { return { { s, s, s, s } }; }
+	inline float First(Float4 v) { return v.v[0]; }
+
+	inline Float4 Add(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	inline Float4 Sub(Float4 a, Float4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+	inline Float4 Mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+	inline Float4 Div(Float4 a, Float4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+
+	template <int X, int Y, int Z, int W>
+	inline Float4 Shuffle(Float4 a, Float4 b) { return { { a.v[X], a.v[Y], b.v[Z], b.v[W] } }; }
+
+	template <int X, int Y, int Z, int W>
+	inline Float4 Swizzle(Float4 v) { return { { v.v[X], v.v[Y], v.v[Z], v.v[W] } }; }
+
+	template <int I>
+	inline Float4 SplatLane(Float4 v) { return Splat(v.v[I]); }
+
+	// -- 32-bit unsigned integer lanes --
+	struct UInt4 {
+		uint32_t v[4];
+	};
+
+	inline UInt4 LoadUInt(const uint32_t* p) { return { { p[0], p[1], p[2], p[3] } }; }
+	inline void StoreUInt(uint32_t* p, UInt4 v) {
+		p[0] = v.v[0];
+		p[1] = v.v[1];
+		p[2] = v.v[2];
+		p[3] = v.v[3];
+	}
+	inline UInt4 SplatUInt(uint32_t s) { return { { s, s, s, s } }; }
+	inline UInt4 Add(UInt4 a, UInt4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	inline UInt4 Xor(UInt4 a, UInt4 b) { return { { a.v[0] ^ b.v[0], a.v[1] ^ b.v[1], a.v[2] ^ b.v[2], a.v[3] ^ b.v[3] } }; }
+
+	inline void MulHiLo(UInt4 a, uint32_t m, UInt4& hi, UInt4& lo) {
+		for (int i = 0; i < 4; ++i) {
+			const uint64_t p = uint64_t(a.v[i]) * m;
+			hi.v[i] = uint32_t(p >> 32);
+			lo.v[i] = uint32_t(p);
+		}
+	}
+
+	inline Float4 ToUnitFloat(UInt4 v) {
+		return { { float(v.v[0] >> 8) * (1.0f / 16777216.0f), float(v.v[1] >> 8) * (1.0f / 16777216.0f),
+			float(v.v[2] >> 8) * (1.0f / 16777216.0f), float(v.v[3] >> 8) * (1.0f / 16777216.0f) } };
+	}
+
+	// -- Min/max and comparisons, masks come back as one bit per lane --
+	// same operand order as minps/maxps: the second operand wins when a lane is NaN
+	inline Float4 Min(Float4 a, Float4 b) { return { { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] } }; }
+	inline Float4 Max(Float4 a, Float4 b) { return { { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] } }; }
+	inline int LessMask(Float4 a, Float4 b) { return (a.v[0] < b.v[0]) | (a.v[1] < b.v[1]) << 1 | (a.v[2] < b.v[2]) << 2 | (a.v[3] < b.v[3]) << 3; }
+	inline int LessEqualMask(Float4 a, Float4 b) { return (a.v[0] <= b.v[0]) | (a.v[1] <= b.v[1]) << 1 | (a.v[2] <= b.v[2]) << 2 | (a.v[3] <= b.v[3]) << 3; }
+
+	// -- Bit-level access, integer lanes are read as signed where it matters --
+	inline UInt4 Sub(UInt4 a, UInt4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+	inline UInt4 And(UInt4 a, UInt4 b) { return { { a.v[0] & b.v[0], a.v[1] & b.v[1], a.v[2] & b.v[2], a.v[3] & b.v[3] } }; }
+	template <int N>
+	inline UInt4 ShiftLeft(UInt4 v) { return { { v.v[0] << N, v.v[1] << N, v.v[2] << N, v.v[3] << N } }; }
+	template <int N>
+	inline UInt4 ShiftRight(UInt4 v) { return { { v.v[0] >> N, v.v[1] >> N, v.v[2] >> N, v.v[3] >> N } }; }
+	inline UInt4 RoundToInt(Float4 v) {
+		// nearest, ties to even like cvtps2dq
+		return { { uint32_t(int32_t(std::nearbyint(v.v[0]))), uint32_t(int32_t(std::nearbyint(v.v[1]))),
+			uint32_t(int32_t(std::nearbyint(v.v[2]))), uint32_t(int32_t(std::nearbyint(v.v[3]))) } };
+	}
+	inline Float4 ToFloat(UInt4 v) { return { { float(int32_t(v.v[0])), float(int32_t(v.v[1])), float(int32_t(v.v[2])), float(int32_t(v.v[3])) } }; }
+	inline UInt4 AsUInt(Float4 v) { return std::bit_cast<UInt4>(v); }
+	inline Float4 AsFloat(UInt4 v) { return std::bit_cast<Float4>(v); }
+#endif
+
+#if defined(MATH_SIMD_AVX) && defined(__AVX2__)
+	// -- 8-wide lanes, only used by the batch functions of math/FastMath.h --
+#define MATH_SIMD_WIDE8 1
+	using Float8 = __m256;
+	using UInt8 = __m256i;
+
+	inline Float8 LoadUnaligned8(const float* p) { return _mm256_loadu_ps(p); }
+	inline void StoreUnaligned(float* p, Float8 v) { _mm256_storeu_ps(p, v); }
+	inline Float8 Splat8(float s) { return _mm256_set1_ps(s); }
+	inline UInt8 SplatUInt8(uint32_t s) { return _mm256_set1_epi32(static_cast<int>(s)); }
+
+	inline Float8 Add(Float8 a, Float8 b) { return _mm256_add_ps(a, b); }
+	inline Float8 Sub(Float8 a, Float8 b) { return _mm256_sub_ps(a, b); }
+	inline Float8 Mul(Float8 a, Float8 b) { return _mm256_mul_ps(a, b); }
+	inline Float8 Div(Float8 a, Float8 b) { return _mm256_div_ps(a, b); }
+	inline Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a, b); }
+	inline Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a, b); }
+
+	inline UInt8 Add(UInt8 a, UInt8 b) { return _mm256_add_epi32(a, b); }
+	inline UInt8 Sub(UInt8 a, UInt8 b) { return _mm256_sub_epi32(a, b); }
+	inline UInt8 And(UInt8 a, UInt8 b) { return _mm256_and_si256(a, b); }
+	inline UInt8 Xor(UInt8 a, UInt8 b) { return _mm256_xor_si256(a, b); }
+	template <int N>
+	inline UInt8 ShiftLeft(UInt8 v) { return _mm256_slli_epi32(v, N); }
+	template <int N>
+	inline UInt8 ShiftRight(UInt8 v) { return _mm256_srli_epi32(v, N); }
+	inline UInt8 RoundToInt(Float8 v) { return _mm256_cvtps_epi32(v); }
+	inline Float8 ToFloat(UInt8 v) { return _mm256_cvtepi32_ps(v); }
+	inline UInt8 AsUInt(Float8 v) { return _mm256_castps_si256(v); }
+	inline Float8 AsFloat(UInt8 v) { return _mm256_castsi256_ps(v); }
+#endif
+
+#if defined(MATH_SIMD_HALF)
+	// -- IEEE half conversion, round to nearest even --
+#if defined(MATH_SIMD_SSE)
+	inline void FloatToHalf4(const float* in, uint16_t* out) { _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_cvtps_ph(_mm_loadu_ps(in), _MM_FROUND_TO_NEAREST_INT)); }
+	inline void HalfToFloat4(const uint16_t* in, float* out) { _mm_storeu_ps(out, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)))); }
+#else
+	inline void FloatToHalf4(const float* in, uint16_t* out) { vst1_u16(out, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in)))); }
+	inline void HalfToFloat4(const uint16_t* in, float* out) { vst1q_f32(out, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in)))); }
+#endif
+#endif
+
+	/*********************************************************************
+	******************************* Kernels ******************************
+	**********************************************************************/
+	// All kernels work on column-major 4x4 float arrays that are 16-byte aligned.
+	// They are written on top of the wrappers above and keep the evaluation order
+	// of the scalar code, so every backend produces the same results.
+
+	inline Float4 Cross(Float4 a, Float4 b) {
+		return Sub(Mul(Swizzle<1, 2, 0, 3>(a), Swizzle<2, 0, 1, 3>(b)), Mul(Swizzle<2, 0, 1, 3>(a), Swizzle<1, 2, 0, 3>(b)));
+	}
+
+	// (x + y) + (z + w), broadcast to every lane
+	inline Float4 HorizontalAdd(Float4 v) {
+		Float4 pair = Add(v, Swizzle<1, 0, 3, 2>(v));
+		return Add(pair, Swizzle<2, 3, 0, 1>(pair));
+	}
+
+	inline Float4 MulColumn(const Float4 c[4], Float4 v) {
+		return Add(Add(Add(Mul(c[0], SplatLane<0>(v)), Mul(c[1], SplatLane<1>(v))), Mul(c[2], SplatLane<2>(v))), Mul(c[3], SplatLane<3>(v)));
+	}
+
+	inline void MulMatrix4(const float* a, const float* b, float* out) {
+#if defined(MATH_SIMD_AVX)
+		// two result columns per iteration
+		const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+		const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+		const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+		const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+		for (int i = 0; i < 16; i += 8) {
+			__m256 r = _mm256_mul_ps(a0, _mm256_setr_m128(_mm_set1_ps(b[i + 0]), _mm_set1_ps(b[i + 4])));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_setr_m128(_mm_set1_ps(b[i + 1]), _mm_set1_ps(b[i + 5]))));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_setr_m128(_mm_set1_ps(b[i + 2]), _mm_set1_ps(b[i + 6]))));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_setr_m128(_mm_set1_ps(b[i + 3]), _mm_set1_ps(b[i + 7]))));
+			_mm256_storeu_ps(out + i, r); // Matrix4 is only 16-byte aligned
+		}
+#else
+		const Float4 ca[4] = { Load(a), Load(a + 4), Load(a + 8), Load(a + 12) };
+		const Float4 cb[4] = { Load(b), Load(b + 4), Load(b + 8), Load(b + 12) };
+		for (int i = 0; i < 4; ++i)
+			Store(out + 4 * i, MulColumn(ca, cb[i]));
+#endif
+	}
+
+	inline void MulMatrix4Vector4(const float* m, const float* v, float* out) {
+		const Float4 c[4] = { Load(m), Load(m + 4), Load(m + 8), Load(m + 12) };
+		Store(out, MulColumn(c, Load(v)));
+	}
+
+	inline void Transpose(Float4& c0, Float4& c1, Float4& c2, Float4& c3) {
+		const Float4 t0 = Shuffle<0, 1, 0, 1>(c0, c1);
+		const Float4 t1 = Shuffle<0, 1, 0, 1>(c2, c3);
+		const Float4 t2 = Shuffle<2, 3, 2, 3>(c0, c1);
+		const Float4 t3 = Shuffle<2, 3, 2, 3>(c2, c3);
+		c0 = Shuffle<0, 2, 0, 2>(t0, t1);
+		c1 = Shuffle<1, 3, 1, 3>(t0, t1);
+		c2 = Shuffle<0, 2, 0, 2>(t2, t3);
+		c3 = Shuffle<1, 3, 1, 3>(t2, t3);
+	}
+
+	inline void TransposeMatrix4(const float* m, float* out) {
+		Float4 c0 = Load(m), c1 = Load(m + 4), c2 = Load(m + 8), c3 = Load(m + 12);
+		Transpose(c0, c1, c2, c3);
+		Store(out, c0);
+		Store(out + 4, c1);
+		Store(out + 8, c2);
+		Store(out + 12, c3);
+	}
+
+	// Translate(p) * RotateY(theta) * Scale(s) for four entities, one entity per lane,
+	// written as four consecutive matrices.
+	inline void ComposeTRS4(Float4 px, Float4 py, Float4 pz, Float4 sinTheta, Float4 cosTheta, Float4 sx, Float4 sy, Float4 sz, float* out) {
+		const Float4 zero = Splat(0.0f);
+		Float4 c00 = Mul(cosTheta, sx), c01 = zero, c02 = Mul(Sub(zero, sinTheta), sx), c03 = zero;
+		Float4 c10 = zero, c11 = sy, c12 = zero, c13 = zero;
+		Float4 c20 = Mul(sinTheta, sz), c21 = zero, c22 = Mul(cosTheta, sz), c23 = zero;
+		Float4 c30 = px, c31 = py, c32 = pz, c33 = Splat(1.0f);
+		Transpose(c00, c01, c02, c03);
+		Transpose(c10, c11, c12, c13);
+		Transpose(c20, c21, c22, c23);
+		Transpose(c30, c31, c32, c33);
+		const Float4 columns[16] = { c00, c10, c20, c30, c01, c11, c21, c31, c02, c12, c22, c32, c03, c13, c23, c33 };
+		for (int i = 0; i < 16; ++i)
+			Store(out + 4 * i, columns[i]);
+	}
+
+	// Transpose of the rotation part, translation becomes -(R^T * t). The last row of m must be (0, 0, 0, 1).
+	inline void InverseRigidMatrix4(const float* m, float* out) {
+		Float4 c0 = Load(m), c1 = Load(m + 4), c2 = Load(m + 8), c3 = Set(0.0f, 0.0f, 0.0f, 1.0f);
+		const Float4 t = Load(m + 12);
+		Transpose(c0, c1, c2, c3);
+		const Float4 rt = Add(Add(Mul(c0, SplatLane<0>(t)), Mul(c1, SplatLane<1>(t))), Mul(c2, SplatLane<2>(t)));
+		Store(out, c0);
+		Store(out + 4, c1);
+		Store(out + 8, c2);
+		Store(out + 12, Sub(c3, rt));
+	}
+
+	inline void MulVector4Matrix4(const float* v, const float* m, float* out) {
+		alignas(16) float t[16];
+		TransposeMatrix4(m, t);
+		MulMatrix4Vector4(t, v, out);
+	}
+
+	// (c2[A]*c3[B] - c3[A]*c2[B], same, c1[A]*c3[B] - c3[A]*c1[B], c1[A]*c2[B] - c2[A]*c1[B])
+	template <int A, int B>
+	inline Float4 InverseFactor(Float4 c1, Float4 c2, Float4 c3) {
+		const Float4 a = Shuffle<A, A, A, A>(c2, c1);
+		const Float4 b = Swizzle<0, 0, 0, 2>(Shuffle<B, B, B, B>(c3, c2));
+		const Float4 c = Swizzle<0, 0, 0, 2>(Shuffle<A, A, A, A>(c3, c2));
+		const Float4 d = Shuffle<B, B, B, B>(c2, c1);
+		return Sub(Mul(a, b), Mul(c, d));
+	}
+
+	// (c1[I], c0[I], c0[I], c0[I])
+	template <int I>
+	inline Float4 InverseVec(Float4 c0, Float4 c1) { return Swizzle<0, 2, 2, 2>(Shuffle<I, I, I, I>(c1, c0)); }
+
+	// Same cofactor expansion as the scalar Math::Inverse, four lanes at a time.
+	inline void InverseMatrix4(const float* m, float* out) {
+		const Float4 c0 = Load(m), c1 = Load(m + 4), c2 = Load(m + 8), c3 = Load(m + 12);
+
+		const Float4 Fac0 = InverseFactor<2, 3>(c1, c2, c3);
+		const Float4 Fac1 = InverseFactor<1, 3>(c1, c2, c3);
+		const Float4 Fac2 = InverseFactor<1, 2>(c1, c2, c3);
+		const Float4 Fac3 = InverseFactor<0, 3>(c1, c2, c3);
+		const Float4 Fac4 = InverseFactor<0, 2>(c1, c2, c3);
+		const Float4 Fac5 = InverseFactor<0, 1>(c1, c2, c3);
+
+		const Float4 Vec0 = InverseVec<0>(c0, c1);
+		const Float4 Vec1 = InverseVec<1>(c0, c1);
+		const Float4 Vec2 = InverseVec<2>(c0, c1);
+		const Float4 Vec3 = InverseVec<3>(c0, c1);
+
+		const Float4 SignA = Set(+1, -1, +1, -1);
+		const Float4 SignB = Set(-1, +1, -1, +1);
+		const Float4 Inv0 = Mul(Add(Sub(Mul(Vec1, Fac0), Mul(Vec2, Fac1)), Mul(Vec3, Fac2)), SignA);
+		const Float4 Inv1 = Mul(Add(Sub(Mul(Vec0, Fac0), Mul(Vec2, Fac3)), Mul(Vec3, Fac4)), SignB);
+		const Float4 Inv2 = Mul(Add(Sub(Mul(Vec0, Fac1), Mul(Vec1, Fac3)), Mul(Vec3, Fac5)), SignA);
+		const Float4 Inv3 = Mul(Add(Sub(Mul(Vec0, Fac2), Mul(Vec1, Fac4)), Mul(Vec2, Fac5)), SignB);
+
+		const Float4 Row0 = Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 0, 0>(Inv0, Inv1), Shuffle<0, 0, 0, 0>(Inv2, Inv3));
+		const Float4 OneOverDeterminant = Div(Splat(1.0f), HorizontalAdd(Mul(c0, Row0)));
+
+		Store(out, Mul(Inv0, OneOverDeterminant));
+		Store(out + 4, Mul(Inv1, OneOverDeterminant));
+		Store(out + 8, Mul(Inv2, OneOverDeterminant));
+		Store(out + 12, Mul(Inv3, OneOverDeterminant));
+	}
+
+	// v + ((q.xyz x v) * q.w + q.xyz x (q.xyz x v)) * 2, q stored as (x, y, z, w)
+	inline void RotateQuaternion(const float* q, float x, float y, float z, float* out) {
+		const Float4 quat = Load(q);
+		const Float4 v = Set(x, y, z, 0.0f);
+		const Float4 uv = Cross(quat, v);
+		const Float4 uuv = Cross(quat, uv);
+		Store(out, Add(v, Mul(Add(Mul(uv, SplatLane<3>(quat)), uuv), Splat(2.0f))));
+	}
+
+	/*********************************************************************
+	******************************* Geometry *****************************
+	**********************************************************************/
+	// Batch tests used by math/Geometry.h, four primitives per call stored as one lane each.
+	// They return a 4-bit mask, bit i belongs to lane i.
+
+	// planes holds six (nx, ny, nz, d) rows. A box is outside when its projected radius along
+	// some plane normal does not reach the positive side of that plane.
+	inline int FrustumOutsideAABB4(const float* planes, Float4 cx, Float4 cy, Float4 cz, Float4 ex, Float4 ey, Float4 ez) {
+		const Float4 zero = Splat(0.0f);
+		int outside = 0;
+		for (int i = 0; i < 6; ++i) {
+			const float* p = planes + 4 * i;
+			const Float4 distance = Add(Add(Add(Mul(cx, Splat(p[0])), Mul(cy, Splat(p[1]))), Mul(cz, Splat(p[2]))), Splat(p[3]));
+			const Float4 radius = Add(Add(Mul(ex, Splat(p[0] < 0 ? -p[0] : p[0])), Mul(ey, Splat(p[1] < 0 ? -p[1] : p[1]))), Mul(ez, Splat(p[2] < 0 ? -p[2] : p[2])));
+			outside |= LessMask(Add(distance, radius), zero);
+		}
+		return outside;
+	}
+
+	// Slab test of one ray against four boxes. origin/invDirection are (x, y, z), entry distances
+	// clamped to [0, tMax] are written to tNear.
+	inline int RayAABB4(const float* origin, const float* invDirection, float tMax,
+		Float4 minX, Float4 minY, Float4 minZ, Float4 maxX, Float4 maxY, Float4 maxZ, float* tNear) {
+		const Float4 ox = Splat(origin[0]), oy = Splat(origin[1]), oz = Splat(origin[2]);
+		const Float4 ix = Splat(invDirection[0]), iy = Splat(invDirection[1]), iz = Splat(invDirection[2]);
+		const Float4 x0 = Mul(Sub(minX, ox), ix), x1 = Mul(Sub(maxX, ox), ix);
+		const Float4 y0 = Mul(Sub(minY, oy), iy), y1 = Mul(Sub(maxY, oy), iy);
+		const Float4 z0 = Mul(Sub(minZ, oz), iz), z1 = Mul(Sub(maxZ, oz), iz);
+		const Float4 enter = Max(Max(Max(Min(x0, x1), Min(y0, y1)), Min(z0, z1)), Splat(0.0f));
+		const Float4 exit = Min(Min(Min(Max(x0, x1), Max(y0, y1)), Max(z0, z1)), Splat(tMax));
+		Store(tNear, enter);
+		return LessEqualMask(enter, exit);
+	}
+
+	// Moller-Trumbore of one ray against four triangles given as v0 and the edges v1 - v0, v2 - v0.
+	// Hit distances are written to t, back faces count as hits.
+	inline int RayTriangle4(const float* origin, const float* direction,
+		Float4 v0x, Float4 v0y, Float4 v0z, Float4 e1x, Float4 e1y, Float4 e1z, Float4 e2x, Float4 e2y, Float4 e2z, float* t) {
+		const Float4 dx = Splat(direction[0]), dy = Splat(direction[1]), dz = Splat(direction[2]);
+		// p = direction x e2
+		const Float4 px = Sub(Mul(dy, e2z), Mul(dz, e2y));
+		const Float4 py = Sub(Mul(dz, e2x), Mul(dx, e2z));
+		const Float4 pz = Sub(Mul(dx, e2y), Mul(dy, e2x));
+		const Float4 det = Add(Add(Mul(e1x, px), Mul(e1y, py)), Mul(e1z, pz));
+		const Float4 invDet = Div(Splat(1.0f), det);
+
+		const Float4 sx = Sub(Splat(origin[0]), v0x), sy = Sub(Splat(origin[1]), v0y), sz = Sub(Splat(origin[2]), v0z);
+		const Float4 u = Mul(Add(Add(Mul(sx, px), Mul(sy, py)), Mul(sz, pz)), invDet);
+		// q = s x e1
+		const Float4 qx = Sub(Mul(sy, e1z), Mul(sz, e1y));
+		const Float4 qy = Sub(Mul(sz, e1x), Mul(sx, e1z));
+		const Float4 qz = Sub(Mul(sx, e1y), Mul(sy, e1x));
+		const Float4 v = Mul(Add(Add(Mul(dx, qx), Mul(dy, qy)), Mul(dz, qz)), invDet);
+		const Float4 distance = Mul(Add(Add(Mul(e2x, qx), Mul(e2y, qy)), Mul(e2z, qz)), invDet);
+		Store(t, distance);
+
+		const Float4 zero = Splat(0.0f), epsilon = Splat(1e-7f);
+		// parallel rays leave det at 0 and everything else at inf/NaN, the first test rejects them
+		return LessMask(Mul(epsilon, epsilon), Mul(det, det)) & LessEqualMask(zero, u) & LessEqualMask(zero, v)
+			& LessEqualMask(Add(u, v), Splat(1.0f)) & LessMask(epsilon, distance);
+	}
+}
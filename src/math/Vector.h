@@ -1,5 +1,7 @@
 #pragma once
 #include "Defines.h"
+#include "math/Simd.h"
+#include <type_traits>
 /***********************************************************************
 ******************************* Vector2 *******************************
 ***********************************************************************/
@@ -9,29 +11,67 @@ public:
     float x{ 0.f }, y{ 0.f };
 
 public:
-    Vector2();
+    constexpr Vector2() noexcept = default;
 
-    Vector2(const Vector2 & m);
-    Vector2(float x, float y);
-    Vector2(float scalar);
+    constexpr Vector2(const Vector2 & m) noexcept = default;
+    constexpr Vector2(float x, float y) noexcept : x(x), y(y) {}
+    constexpr Vector2(float scalar) noexcept : x(scalar), y(scalar) {}
 
-    float& operator[](int i);
-    const float& operator[](int i) const;
+    constexpr float& operator[](int i) noexcept {
+        assert(i < 2);
+        return i == 0 ? x : y;
+    }
+    constexpr const float& operator[](int i) const noexcept {
+        assert(i < 2);
+        return i == 0 ? x : y;
+    }
 
     // -- Unary arithmetic operators --
-    Vector2& operator=(const Vector2 & v);
-    Vector2& operator+=(const Vector2 & v);
-
-    Vector2& operator+=(float v);
-    Vector2& operator-=(const Vector2 & v);
-
-    Vector2& operator-=(float v);
-    Vector2& operator*=(const Vector2 & v);
-
-    Vector2& operator*=(float v);
-    Vector2& operator/=(const Vector2 & v);
-
-    Vector2& operator/=(float v);
+    constexpr Vector2& operator=(const Vector2 & v) noexcept = default;
+    constexpr Vector2& operator+=(const Vector2 & v) noexcept {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator+=(float v) noexcept {
+        x += v;
+        y += v;
+        return *this;
+    }
+    constexpr Vector2& operator-=(const Vector2 & v) noexcept {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator-=(float v) noexcept {
+        x -= v;
+        y -= v;
+        return *this;
+    }
+    constexpr Vector2& operator*=(const Vector2 & v) noexcept {
+        x *= v.x;
+        y *= v.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator*=(float v) noexcept {
+        x *= v;
+        y *= v;
+        return *this;
+    }
+    constexpr Vector2& operator/=(const Vector2 & v) noexcept {
+        x /= v.x;
+        y /= v.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator/=(float v) noexcept {
+        x /= v;
+        y /= v;
+        return *this;
+    }
 
     static const Vector2 ZERO;
     static const Vector2 ONE;
@@ -40,37 +80,44 @@ public:
     static const Vector2 NEGATIVE_UNIT_X;
     static const Vector2 NEGATIVE_UNIT_Y;
 };
+inline constexpr Vector2 Vector2::ZERO(0, 0);
+inline constexpr Vector2 Vector2::ONE(1, 1);
+inline constexpr Vector2 Vector2::UNIT_X(1, 0);
+inline constexpr Vector2 Vector2::UNIT_Y(0, 1);
+inline constexpr Vector2 Vector2::NEGATIVE_UNIT_X(-1, 0);
+inline constexpr Vector2 Vector2::NEGATIVE_UNIT_Y(0, -1);
+
 // -- Unary operators --
-Vector2 operator+(const Vector2& m);
-Vector2 operator-(const Vector2& m);
+constexpr Vector2 operator+(const Vector2& m) noexcept { return m; }
+constexpr Vector2 operator-(const Vector2& m) noexcept { return Vector2(0) -= m; }
 // -- Binary operators --
-Vector2 operator+(const Vector2& m, const Vector2& s);
+constexpr Vector2 operator+(const Vector2& m, const Vector2& s) noexcept { return Vector2(m) += s; }
 
-Vector2 operator+(const float& s, const Vector2& m);
+constexpr Vector2 operator+(const float& s, const Vector2& m) noexcept { return Vector2(m) += s; }
 
-Vector2 operator+(const Vector2& m, const float& s);
+constexpr Vector2 operator+(const Vector2& m, const float& s) noexcept { return Vector2(m) += s; }
 
-Vector2 operator-(const Vector2& m, const Vector2& s);
+constexpr Vector2 operator-(const Vector2& m, const Vector2& s) noexcept { return Vector2(m) -= s; }
 
-Vector2 operator-(const float& m, const Vector2& s);
+constexpr Vector2 operator-(const float& m, const Vector2& s) noexcept { return Vector2(m) -= s; }
 
-Vector2 operator-(const Vector2& s, const float& m);
+constexpr Vector2 operator-(const Vector2& s, const float& m) noexcept { return Vector2(s) -= m; }
 
-Vector2 operator*(const Vector2& m, const Vector2& s);
+constexpr Vector2 operator*(const Vector2& m, const Vector2& s) noexcept { return Vector2(m) *= s; }
 
-Vector2 operator*(const float& m, const Vector2& s);
+constexpr Vector2 operator*(const float& m, const Vector2& s) noexcept { return Vector2(s) *= m; }
 
-Vector2 operator*(const Vector2& s, const float& m);
+constexpr Vector2 operator*(const Vector2& s, const float& m) noexcept { return Vector2(s) *= m; }
 
-Vector2 operator/(const Vector2& m, const Vector2& s);
+constexpr Vector2 operator/(const Vector2& m, const Vector2& s) noexcept { return Vector2(m) /= s; }
 
-Vector2 operator/(const float& m, const Vector2& s);
+constexpr Vector2 operator/(const float& m, const Vector2& s) noexcept { return Vector2(m) /= s; }
 
-Vector2 operator/(const Vector2& s, const float& m);
+constexpr Vector2 operator/(const Vector2& s, const float& m) noexcept { return Vector2(s) /= m; }
 
 // -- Boolean operators --
-bool operator==(const Vector2& m, const Vector2& s);
-bool operator!=(const Vector2& m, const Vector2& s);
+constexpr bool operator==(const Vector2& m, const Vector2& s) noexcept { return (m.x == s.x) && (m.y == s.y); }
+constexpr bool operator!=(const Vector2& m, const Vector2& s) noexcept { return (m.x != s.x) || (m.y != s.y); }
 
 /***********************************************************************
 ******************************* Vector3 *******************************
@@ -81,29 +128,75 @@ public:
     float x{ 0.f }, y{ 0.f }, z{ 0.f };
 
 public:
-    Vector3();
+    constexpr Vector3() noexcept = default;
 
-    Vector3(const Vector3 & m);
-    Vector3(float x, float y, float z);
-    Vector3(float scalar);
+    constexpr Vector3(const Vector3 & m) noexcept = default;
+    constexpr Vector3(float x, float y, float z) noexcept : x(x), y(y), z(z) {}
+    constexpr Vector3(float scalar) noexcept : x(scalar), y(scalar), z(scalar) {}
 
-    float& operator[](int i);
-    const float& operator[](int i) const;
+    constexpr float& operator[](int i) noexcept {
+        assert(i < 3);
+        return i == 0 ? x : (i == 1 ? y : z);
+    }
+    constexpr const float& operator[](int i) const noexcept {
+        assert(i < 3);
+        return i == 0 ? x : (i == 1 ? y : z);
+    }
 
     // -- Unary arithmetic operators --
-    Vector3& operator=(const Vector3 & v);
-    Vector3& operator+=(const Vector3 & v);
-
-    Vector3& operator+=(float v);
-    Vector3& operator-=(const Vector3 & v);
-
-    Vector3& operator-=(float v);
-    Vector3& operator*=(const Vector3 & v);
-
-    Vector3& operator*=(float v);
-    Vector3& operator/=(const Vector3 & v);
-
-    Vector3& operator/=(float v);
+    constexpr Vector3& operator=(const Vector3 & v) noexcept = default;
+    constexpr Vector3& operator+=(const Vector3 & v) noexcept {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator+=(float v) noexcept {
+        x += v;
+        y += v;
+        z += v;
+        return *this;
+    }
+    constexpr Vector3& operator-=(const Vector3 & v) noexcept {
+        x -= v.x;
+        y -= v.y;
+        z -= v.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator-=(float v) noexcept {
+        x -= v;
+        y -= v;
+        z -= v;
+        return *this;
+    }
+    constexpr Vector3& operator*=(const Vector3 & v) noexcept {
+        x *= v.x;
+        y *= v.y;
+        z *= v.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator*=(float v) noexcept {
+        x *= v;
+        y *= v;
+        z *= v;
+        return *this;
+    }
+    constexpr Vector3& operator/=(const Vector3 & v) noexcept {
+        x /= v.x;
+        y /= v.y;
+        z /= v.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator/=(float v) noexcept {
+        x /= v;
+        y /= v;
+        z /= v;
+        return *this;
+    }
 
     static const Vector3 ZERO;
     static const Vector3 ONE;
@@ -114,97 +207,141 @@ public:
     static const Vector3 NEGATIVE_UNIT_Y;
     static const Vector3 NEGATIVE_UNIT_Z;
 };
+inline constexpr Vector3 Vector3::ZERO(0, 0, 0);
+inline constexpr Vector3 Vector3::ONE(1, 1, 1);
+inline constexpr Vector3 Vector3::UNIT_X(1, 0, 0);
+inline constexpr Vector3 Vector3::UNIT_Y(0, 1, 0);
+inline constexpr Vector3 Vector3::UNIT_Z(0, 0, 1);
+inline constexpr Vector3 Vector3::NEGATIVE_UNIT_X(-1, 0, 0);
+inline constexpr Vector3 Vector3::NEGATIVE_UNIT_Y(0, -1, 0);
+inline constexpr Vector3 Vector3::NEGATIVE_UNIT_Z(0, 0, -1);
+
 // -- Unary operators --
-Vector3 operator+(const Vector3& m);
-Vector3 operator-(const Vector3& m);
+constexpr Vector3 operator+(const Vector3& m) noexcept { return m; }
+constexpr Vector3 operator-(const Vector3& m) noexcept { return Vector3(0) -= m; }
 // -- Binary operators --
-Vector3 operator+(const Vector3& m, const Vector3& s);
+constexpr Vector3 operator+(const Vector3& m, const Vector3& s) noexcept { return Vector3(m) += s; }
 
-Vector3 operator+(const float& s, const Vector3& m);
+constexpr Vector3 operator+(const float& s, const Vector3& m) noexcept { return Vector3(m) += s; }
 
-Vector3 operator+(const Vector3& m, const float& s);
+constexpr Vector3 operator+(const Vector3& m, const float& s) noexcept { return Vector3(m) += s; }
 
-Vector3 operator-(const Vector3& m, const Vector3& s);
+constexpr Vector3 operator-(const Vector3& m, const Vector3& s) noexcept { return Vector3(m) -= s; }
 
-Vector3 operator-(const float& m, const Vector3& s);
+constexpr Vector3 operator-(const float& m, const Vector3& s) noexcept { return Vector3(m) -= s; }
 
-Vector3 operator-(const Vector3& s, const float& m);
+constexpr Vector3 operator-(const Vector3& s, const float& m) noexcept { return Vector3(s) -= m; }
 
-Vector3 operator*(const Vector3& m, const Vector3& s);
+constexpr Vector3 operator*(const Vector3& m, const Vector3& s) noexcept { return Vector3(m) *= s; }
 
-Vector3 operator*(const float& m, const Vector3& s);
+constexpr Vector3 operator*(const float& m, const Vector3& s) noexcept { return Vector3(s) *= m; }
 
-Vector3 operator*(const Vector3& s, const float& m);
+constexpr Vector3 operator*(const Vector3& s, const float& m) noexcept { return Vector3(s) *= m; }
 
-Vector3 operator/(const Vector3& m, const Vector3& s);
+constexpr Vector3 operator/(const Vector3& m, const Vector3& s) noexcept { return Vector3(m) /= s; }
 
-Vector3 operator/(const float& m, const Vector3& s);
+constexpr Vector3 operator/(const float& m, const Vector3& s) noexcept { return Vector3(m) /= s; }
 
-Vector3 operator/(const Vector3& s, const float& m);
+constexpr Vector3 operator/(const Vector3& s, const float& m) noexcept { return Vector3(s) /= m; }
 
 // -- Boolean operators --
-bool operator==(const Vector3& m, const Vector3& s);
-bool operator!=(const Vector3& m, const Vector3& s);
+constexpr bool operator==(const Vector3& m, const Vector3& s) noexcept { return (m.x == s.x) && (m.y == s.y) && (m.z == s.z); }
+constexpr bool operator!=(const Vector3& m, const Vector3& s) noexcept { return (m.x != s.x) || (m.y != s.y) || (m.z != s.z); }
 
 /***********************************************************************
 ******************************* Vector4 *******************************
 ***********************************************************************/
 
-class Vector4 {
+// 16-byte aligned so the SIMD backend can load it (and Matrix4 columns) directly.
+// The compound operators fall back to scalar code during constant evaluation.
+class alignas(16) Vector4 {
 public:
     float x{ 0.f }, y{ 0.f }, z{ 0.f }, w{ 0.f };
 
 public:
-    Vector4();
-
-    Vector4(const Vector4 & m);
-    Vector4(float x, float y, float z, float w);
-    Vector4(const Vector3 & v, float w);
-    Vector4(float scalar);
-
-    float& operator[](int i);
-    const float& operator[](int i) const;
+    constexpr Vector4() noexcept = default;
+
+    constexpr Vector4(const Vector4 & m) noexcept = default;
+    constexpr Vector4(float x, float y, float z, float w) noexcept : x(x), y(y), z(z), w(w) {}
+    constexpr Vector4(const Vector3 & v, float w) noexcept : x(v.x), y(v.y), z(v.z), w(w) {}
+    constexpr Vector4(float scalar) noexcept : x(scalar), y(scalar), z(scalar), w(scalar) {}
+
+    constexpr float& operator[](int i) noexcept {
+        assert(i < 4);
+        if (std::is_constant_evaluated())
+            return i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w));
+        return (&x)[i];
+    }
+    constexpr const float& operator[](int i) const noexcept {
+        assert(i < 4);
+        if (std::is_constant_evaluated())
+            return i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w));
+        return (&x)[i];
+    }
 
     // -- Unary arithmetic operators --
-    Vector4& operator=(const Vector4 & v);
-    Vector4& operator+=(const Vector4 & v);
-
-    Vector4& operator+=(float v);
-    Vector4& operator-=(const Vector4 & v);
-
-    Vector4& operator-=(float v);
-    Vector4& operator*=(const Vector4 & v);
-
-    Vector4& operator*=(float v);
-    Vector4& operator/=(const Vector4 & v);
-
-    Vector4& operator/=(float v);
-
-    operator Vector3() const;
+    constexpr Vector4& operator=(const Vector4 & v) noexcept = default;
+    constexpr Vector4& operator+=(const Vector4 & v) noexcept {
+        if (std::is_constant_evaluated())
+            return *this = Vector4(x + v.x, y + v.y, z + v.z, w + v.w);
+        Simd::Store(&x, Simd::Add(Simd::Load(&x), Simd::Load(&v.x)));
+        return *this;
+    }
+
+    constexpr Vector4& operator+=(float v) noexcept { return *this += Vector4(v); }
+    constexpr Vector4& operator-=(const Vector4 & v) noexcept {
+        if (std::is_constant_evaluated())
+            return *this = Vector4(x - v.x, y - v.y, z - v.z, w - v.w);
+        Simd::Store(&x, Simd::Sub(Simd::Load(&x), Simd::Load(&v.x)));
+        return *this;
+    }
+
+    constexpr Vector4& operator-=(float v) noexcept { return *this -= Vector4(v); }
+    constexpr Vector4& operator*=(const Vector4 & v) noexcept {
+        if (std::is_constant_evaluated())
+            return *this = Vector4(x * v.x, y * v.y, z * v.z, w * v.w);
+        Simd::Store(&x, Simd::Mul(Simd::Load(&x), Simd::Load(&v.x)));
+        return *this;
+    }
+
+    constexpr Vector4& operator*=(float v) noexcept { return *this *= Vector4(v); }
+    constexpr Vector4& operator/=(const Vector4 & v) noexcept {
+        if (std::is_constant_evaluated())
+            return *this = Vector4(x / v.x, y / v.y, z / v.z, w / v.w);
+        Simd::Store(&x, Simd::Div(Simd::Load(&x), Simd::Load(&v.x)));
+        return *this;
+    }
+
+    constexpr Vector4& operator/=(float v) noexcept { return *this /= Vector4(v); }
+
+    constexpr operator Vector3() const noexcept { return Vector3(x, y, z); }
 
     static const Vector4 ZERO;
     static const Vector4 ONE;
 };
+inline constexpr Vector4 Vector4::ZERO(0, 0, 0, 0);
+inline constexpr Vector4 Vector4::ONE(1, 1, 1, 1);
+
 // -- Unary operators --
-Vector4 operator+(const Vector4& m);
-Vector4 operator-(const Vector4& m);
+constexpr Vector4 operator+(const Vector4& m) noexcept { return m; }
+constexpr Vector4 operator-(const Vector4& m) noexcept { return Vector4(0) -= m; }
 // -- Binary operators --
-Vector4 operator+(const Vector4& m, const Vector4& s);
-Vector4 operator+(const float& s, const Vector4& m);
-Vector4 operator+(const Vector4& m, const float& s);
+constexpr Vector4 operator+(const Vector4& m, const Vector4& s) noexcept { return Vector4(m) += s; }
+constexpr Vector4 operator+(const float& s, const Vector4& m) noexcept { return Vector4(m) += s; }
+constexpr Vector4 operator+(const Vector4& m, const float& s) noexcept { return Vector4(m) += s; }
 
-Vector4 operator-(const Vector4& m, const Vector4& s);
-Vector4 operator-(const float& m, const Vector4& s);
-Vector4 operator-(const Vector4& s, const float& m);
+constexpr Vector4 operator-(const Vector4& m, const Vector4& s) noexcept { return Vector4(m) -= s; }
+constexpr Vector4 operator-(const float& m, const Vector4& s) noexcept { return Vector4(m) -= s; }
+constexpr Vector4 operator-(const Vector4& s, const float& m) noexcept { return Vector4(s) -= m; }
 
-Vector4 operator*(const Vector4& m, const Vector4& s);
-Vector4 operator*(const float& m, const Vector4& s);
-Vector4 operator*(const Vector4& s, const float& m);
+constexpr Vector4 operator*(const Vector4& m, const Vector4& s) noexcept { return Vector4(m) *= s; }
+constexpr Vector4 operator*(const float& m, const Vector4& s) noexcept { return Vector4(s) *= m; }
+constexpr Vector4 operator*(const Vector4& s, const float& m) noexcept { return Vector4(s) *= m; }
 
-Vector4 operator/(const Vector4& m, const Vector4& s);
-Vector4 operator/(const float& m, const Vector4& s);
-Vector4 operator/(const Vector4& s, const float& m);
+constexpr Vector4 operator/(const Vector4& m, const Vector4& s) noexcept { return Vector4(m) /= s; }
+constexpr Vector4 operator/(const float& m, const Vector4& s) noexcept { return Vector4(m) /= s; }
+constexpr Vector4 operator/(const Vector4& s, const float& m) noexcept { return Vector4(s) /= m; }
 
 // -- Boolean operators --
-bool operator==(const Vector4& m, const Vector4& s);
-bool operator!=(const Vector4& m, const Vector4& s);
\ No newline at end of file
+constexpr bool operator==(const Vector4& m, const Vector4& s) noexcept { return (m.x == s.x) && (m.y == s.y) && (m.z == s.z) && (m.w == s.w); }
+constexpr bool operator!=(const Vector4& m, const Vector4& s) noexcept { return (m.x != s.x) || (m.y != s.y) || (m.z != s.z) || (m.w != s.w); }
@@ -6,9 +6,38 @@ add_requires("assimp")
 add_requires("freetype")
 set_languages("c++20")
 
+option("simd")
+    set_default(true)
+    set_showmenu(true)
+    set_description("Use the SSE/AVX/NEON backend of src/math, disable for the scalar fallback")
+option_end()
+
+option("deterministic")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Run the car simulation on Q16.16 fixed point (math/Deterministic.h) for bit-identical replays")
+option_end()
+
 target("Game")
     set_kind("binary")
     add_files("src/**.cpp")
-    add_headerfiles("src/**.h")
+    add_headerfiles("src/**.h", "src/**.inl")
     add_includedirs("src/", {public  = true})
     add_packages("glfw","glad","assimp","freetype")
+    if not has_config("simd") then
+        add_defines("MATH_NO_SIMD")
+    end
+    if has_config("deterministic") then
+        add_defines("MATH_DETERMINISTIC")
+    end
+
+-- headless benchmarks of src/math, no window or GL context needed
+target("bench_math")
+    set_kind("binary")
+    set_default(false)
+    add_files("bench/*.cpp")
+    add_headerfiles("bench/*.h")
+    add_includedirs("src/")
+    if not has_config("simd") then
+        add_defines("MATH_NO_SIMD")
+    end